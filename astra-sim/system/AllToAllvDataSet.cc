@@ -0,0 +1,70 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "astra-sim/system/AllToAllvDataSet.hh"
+
+#include <algorithm>
+#include <iostream>
+
+#include "astra-sim/system/IntData.hh"
+#include "astra-sim/system/Sys.hh"
+
+using namespace std;
+using namespace AstraSim;
+
+map<pair<int, int>, vector<Tick>> AllToAllvDataSet::durations_per_sequence;
+
+AllToAllvDataSet::AllToAllvDataSet(
+    int sys_id,
+    int group_id,
+    int sequence,
+    int participants,
+    DataSet* all_to_allv)
+    : DataSet(0) {
+  this->sys_id = sys_id;
+  this->group_id = group_id;
+  this->sequence = sequence;
+  this->participants = participants;
+  this->all_to_allv = all_to_allv;
+  if (all_to_allv->active) {
+    total_streams = 1;
+    all_to_allv->set_notifier(this, EventType::CollectiveCommunicationFinished);
+  } else {
+    active = false;
+  }
+}
+
+void AllToAllvDataSet::call(EventType event, CallData* data) {
+  delete (IntData*)data;
+  pair<int, int> key = make_pair(group_id, sequence);
+  vector<Tick>& durations = durations_per_sequence[key];
+  durations.push_back(all_to_allv->finish_tick - all_to_allv->creation_tick);
+  if (durations.size() == (size_t)participants) {
+    report(durations);
+    durations_per_sequence.erase(key);
+  }
+  notify_stream_finished((StreamStat*)all_to_allv);
+}
+
+void AllToAllvDataSet::report(vector<Tick>& durations) {
+  Tick fastest = *min_element(durations.begin(), durations.end());
+  Tick slowest = *max_element(durations.begin(), durations.end());
+  double mean = 0;
+  for (auto duration : durations) {
+    mean += duration;
+  }
+  mean /= durations.size();
+  double tail = 1;
+  if (mean > 0) {
+    tail = slowest / mean;
+  }
+  cout << "sys[" << sys_id << "] all-to-allv #" << sequence;
+  if (group_id >= 0) {
+    cout << " of group " << group_id;
+  }
+  cout << ": fastest NPU " << fastest << " cycles, mean " << mean
+       << " cycles, slowest NPU " << slowest << " cycles, tail " << tail
+       << "x the mean" << endl;
+}
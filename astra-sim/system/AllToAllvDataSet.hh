@@ -0,0 +1,43 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#ifndef __ALL_TO_ALLV_DATASET_HH__
+#define __ALL_TO_ALLV_DATASET_HH__
+
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "astra-sim/system/DataSet.hh"
+
+namespace AstraSim {
+
+// DataSet of an all-to-allv collective. It collects the duration of the
+// collective on every participating NPU, and the last NPU to finish reports
+// how far the slowest NPU trails behind the others. The collectives are
+// numbered per communicator group (-1 for the ones of all the NPUs).
+class AllToAllvDataSet : public DataSet {
+ public:
+  AllToAllvDataSet(
+      int sys_id,
+      int group_id,
+      int sequence,
+      int participants,
+      DataSet* all_to_allv);
+  void call(EventType event, CallData* data);
+  void report(std::vector<Tick>& durations);
+
+  static std::map<std::pair<int, int>, std::vector<Tick>>
+      durations_per_sequence;
+  int sys_id;
+  int group_id;
+  int sequence;
+  int participants;
+  DataSet* all_to_allv;
+};
+
+} // namespace AstraSim
+
+#endif /* __ALL_TO_ALLV_DATASET_HH__ */
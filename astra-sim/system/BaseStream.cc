@@ -20,11 +20,11 @@ void BaseStream::changeState(StreamState state) {
 BaseStream::BaseStream(
     int stream_id,
     Sys* owner,
-    std::list<CollectivePhase> phases_to_go) {
+    std::vector<CollectivePhase>&& phases_to_go)
+    : phases_to_go(std::move(phases_to_go)) {
   this->stream_id = stream_id;
   this->owner = owner;
   this->initialized = false;
-  this->phases_to_go = phases_to_go;
   if (synchronizer.find(stream_id) != synchronizer.end()) {
     synchronizer[stream_id]++;
   } else {
@@ -32,7 +32,7 @@ BaseStream::BaseStream(
     synchronizer[stream_id] = 1;
     ready_counter[stream_id] = 0;
   }
-  for (auto& vn : phases_to_go) {
+  for (auto& vn : this->phases_to_go) {
     if (vn.algorithm != nullptr) {
       vn.init(this);
     }
@@ -6,8 +6,9 @@ LICENSE file in the root directory of this source tree.
 #ifndef __BASE_STREAM_HH__
 #define __BASE_STREAM_HH__
 
-#include <map>
 #include <list>
+#include <map>
+#include <vector>
 
 #include "astra-sim/system/Callable.hh"
 #include "astra-sim/system/CollectivePhase.hh"
@@ -25,7 +26,7 @@ class BaseStream : public Callable, public StreamStat {
   BaseStream(
       int stream_id,
       Sys* owner,
-      std::list<CollectivePhase> phases_to_go);
+      std::vector<CollectivePhase>&& phases_to_go);
   virtual ~BaseStream() = default;
 
   void changeState(StreamState state);
@@ -38,7 +39,7 @@ class BaseStream : public Callable, public StreamStat {
   int stream_id;
   int total_packets_sent;
   SchedulingPolicy preferred_scheduling;
-  std::list<CollectivePhase> phases_to_go;
+  std::vector<CollectivePhase> phases_to_go;
   int current_queue_id;
   CollectivePhase my_current_phase;
   ComType current_com_type;
@@ -55,7 +55,13 @@ enum class ComType {
   All_Gather,
   All_Reduce,
   All_to_All,
-  All_Reduce_All_to_All
+  All_Reduce_All_to_All,
+  Broadcast,
+  Reduce,
+  Gather,
+  Scatter,
+  Barrier,
+  All_to_Allv
 };
 
 enum class CollectiveOptimization {
@@ -66,6 +72,7 @@ enum class CollectiveOptimization {
 enum class CollectiveImplType {
   Ring = 0,
   OneRing,
+  OneRingSnake,
   Direct,
   OneDirect,
   AllToAll,
@@ -75,6 +82,11 @@ enum class CollectiveImplType {
   DoubleBinaryTree,
   HalvingDoubling,
   OneHalvingDoubling,
+  MultiChannelRing,
+  HierarchicalDirect,
+  Chain,
+  BinomialTree,
+  InNetwork,
 };
 
 enum class CollectiveBarrier {
@@ -152,7 +164,30 @@ enum class EventType {
   CollectiveCommunicationFinished,
   CompFinished,
   MemLoadFinished,
-  MemStoreFinished
+  MemStoreFinished,
+  CommBucketTimeout
+};
+
+// Gradient compression applied on the messages of one dimension. The costs
+// are in cycles per uncompressed byte.
+class CompressionConfig {
+ public:
+  CompressionConfig() {
+    this->ratio = 1;
+    this->encode_cost = 0;
+    this->decode_cost = 0;
+    this->survives_reduction = true;
+  }
+  bool is_enabled() const {
+    return ratio != 1 || encode_cost != 0 || decode_cost != 0;
+  }
+
+  double ratio;
+  double encode_cost;
+  double decode_cost;
+  // whether the reduction can run on the compressed data (e.g. PowerSGD),
+  // otherwise every step decodes, reduces and encodes again (e.g. top-k)
+  bool survives_reduction;
 };
 
 class CloneInterface {
@@ -188,6 +223,21 @@ class DirectCollectiveImpl : public CollectiveImpl {
   int direct_collective_window;
 };
 
+class MultiChannelCollectiveImpl : public CollectiveImpl {
+ public:
+  CloneInterface* clone() const {
+    return new MultiChannelCollectiveImpl(*this);
+  };
+  MultiChannelCollectiveImpl(
+      CollectiveImplType type,
+      int channels)
+      : CollectiveImpl(type) {
+    this->channels = channels;
+  }
+
+  int channels;
+};
+
 } // namespace AstraSim
 
 #endif /* __COMMON_HH__ */
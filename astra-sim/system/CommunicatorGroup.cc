@@ -6,6 +6,7 @@ LICENSE file in the root directory of this source tree.
 #include "astra-sim/system/CommunicatorGroup.hh"
 
 #include <algorithm>
+#include <set>
 
 #include "astra-sim/system/Sys.hh"
 #include "astra-sim/system/CollectivePlan.hh"
@@ -28,13 +29,22 @@ CommunicatorGroup::~CommunicatorGroup(){
     CollectivePlan* cp = cg.second;
     delete cp;
   }
+  // phase templates are keyed by the plans' topologies and implementations
+  if (!comm_plans.empty()) {
+    generator->clear_phase_templates();
+  }
 }
 
 void CommunicatorGroup::set_id(int id){
-  assert(id>0);
+  assert(id>=0);
   this->id = id;
-  this->num_streams = id*1000000;
+  // the streams of the NPUs outside any group are numbered from 0
+  this->num_streams = (id+1)*1000000;
+
+}
 
+int CommunicatorGroup::get_id(){
+  return id;
 }
 
 CollectivePlan* CommunicatorGroup::get_collective_plan(ComType comm_type) {
@@ -51,6 +61,21 @@ CollectivePlan* CommunicatorGroup::get_collective_plan(ComType comm_type) {
       new CollectivePlan(logical_topology, collective_implementation,
           dimensions_involved, should_be_removed);
     return comm_plans[comm_type];
+  }
+  LogicalTopology *world_topology = generator->get_logical_topology(comm_type);
+  std::vector<bool> lattice_dimensions;
+  if (get_sub_lattice(world_topology, involved_NPUs, generator->total_nodes,
+                      lattice_dimensions)) {
+    // the rings/trees of the world topology along the dimensions the group
+    // spans only contain NPUs of the group, so the world plan restricted to
+    // those dimensions is the plan of the group
+    std::vector<CollectiveImpl*> collective_implementation
+      = generator->get_collective_implementation(comm_type);
+    bool should_be_removed = false;
+    comm_plans[comm_type] =
+      new CollectivePlan(world_topology, collective_implementation,
+          lattice_dimensions, should_be_removed);
+    return comm_plans[comm_type];
   } else {
     LogicalTopology *logical_topology = new RingTopology(RingTopology::Dimension::Local,generator->id,involved_NPUs);
     std::vector<CollectiveImpl*> collective_implementation{new CollectiveImpl(CollectiveImplType::Ring)};
@@ -62,3 +87,47 @@ CollectivePlan* CommunicatorGroup::get_collective_plan(ComType comm_type) {
     return comm_plans[comm_type];
   }
 }
+
+// A group is a sub-lattice of a logical topology when, with the NPU ids
+// decomposed into mixed-radix coordinates over the dimensions of the
+// topology, it spans every coordinate of some dimensions and a single
+// coordinate of all the others (e.g. a TP group that covers the local
+// dimension, or a DP group striding across the slower dimensions).
+bool CommunicatorGroup::get_sub_lattice(
+    LogicalTopology *topology,
+    const std::vector<int> &involved_NPUs,
+    int total_nodes,
+    std::vector<bool> &dimensions_involved) {
+  int dims = topology->get_num_of_dimensions();
+  int total = 1;
+  for (int dim = 0; dim < dims; dim++) {
+    total *= topology->get_num_of_nodes_in_dimension(dim);
+  }
+  if (total != total_nodes) {
+    return false;
+  }
+  std::vector<std::set<int>> coordinates(dims);
+  for (int npu : involved_NPUs) {
+    int offset = 1;
+    for (int dim = 0; dim < dims; dim++) {
+      int size = topology->get_num_of_nodes_in_dimension(dim);
+      coordinates[dim].insert((npu / offset) % size);
+      offset *= size;
+    }
+  }
+  std::set<int> unique_NPUs(involved_NPUs.begin(), involved_NPUs.end());
+  int spanned = 1;
+  dimensions_involved.assign(dims, true);
+  for (int dim = 0; dim < dims; dim++) {
+    int size = topology->get_num_of_nodes_in_dimension(dim);
+    if (coordinates[dim].size() == size) {
+      spanned *= size;
+    } else if (coordinates[dim].size() == 1) {
+      dimensions_involved[dim] = false;
+    } else {
+      return false;
+    }
+  }
+  return spanned == unique_NPUs.size() &&
+      unique_NPUs.size() == involved_NPUs.size();
+}
@@ -16,12 +16,18 @@ namespace AstraSim {
 
 class Sys;
 class CollectivePlan;
+class LogicalTopology;
 class CommunicatorGroup {
  public:
   CommunicatorGroup(int id, std::vector<int> involved_NPUs, Sys *generator);
   CollectivePlan* get_collective_plan(ComType comm_type);
   void set_id(int id);
+  int get_id();
   ~CommunicatorGroup();
+  static bool get_sub_lattice(LogicalTopology *topology,
+                              const std::vector<int> &involved_NPUs,
+                              int total_nodes,
+                              std::vector<bool> &dimensions_involved);
 
   std::vector<int> involved_NPUs;
   int num_streams;
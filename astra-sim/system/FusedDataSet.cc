@@ -0,0 +1,72 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "astra-sim/system/FusedDataSet.hh"
+
+#include <iostream>
+
+#include "astra-sim/system/IntData.hh"
+#include "astra-sim/system/Sys.hh"
+
+using namespace std;
+using namespace AstraSim;
+
+FusedDataSet::FusedDataSet(
+    int sys_id,
+    DataSet* all_reduce,
+    DataSet* all_to_all)
+    : DataSet(0) {
+  this->sys_id = sys_id;
+  this->all_reduce = all_reduce;
+  this->all_to_all = all_to_all;
+  this->all_reduce_alone = 0;
+  this->all_to_all_alone = 0;
+  if (all_reduce->active) {
+    total_streams++;
+    all_reduce->set_notifier(this, EventType::CollectiveCommunicationFinished);
+  }
+  if (all_to_all->active) {
+    total_streams++;
+    all_to_all->set_notifier(this, EventType::CollectiveCommunicationFinished);
+  }
+  if (total_streams == 0) {
+    active = false;
+  }
+}
+
+void FusedDataSet::call(EventType event, CallData* data) {
+  IntData* int_data = (IntData*)data;
+  DataSet* finished_pattern = all_reduce;
+  if (int_data->data == all_to_all->my_id) {
+    finished_pattern = all_to_all;
+  }
+  delete int_data;
+  if (total_streams == finished_streams + 1) {
+    report();
+  }
+  notify_stream_finished((StreamStat*)finished_pattern);
+}
+
+void FusedDataSet::report() {
+  if (sys_id != 0 || !all_reduce->active || !all_to_all->active) {
+    return;
+  }
+  Tick all_reduce_time = all_reduce->finish_tick - creation_tick;
+  Tick all_to_all_time = all_to_all->finish_tick - creation_tick;
+  Tick fused_time = Sys::boostedTick() - creation_tick;
+  cout << "sys[" << sys_id << "] fused all-reduce/all-to-all #" << my_id
+       << ": all-reduce " << all_reduce_time << " cycles, all-to-all "
+       << all_to_all_time << " cycles, fused " << fused_time << " cycles";
+  // the durations above are slowed down by the other pattern, so the
+  // back-to-back baseline adds up the patterns on their own instead. Their
+  // estimates are lower bounds, and so is the gain.
+  if (all_reduce_alone > 0 && all_to_all_alone > 0) {
+    double back_to_back = all_reduce_alone + all_to_all_alone;
+    double overlap_gain = (back_to_back - fused_time) / back_to_back * 100;
+    cout << ", back-to-back issue >= " << back_to_back
+         << " cycles, overlap gain >= " << overlap_gain << "%";
+  }
+  cout << endl;
+}
@@ -0,0 +1,31 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#ifndef __FUSED_DATASET_HH__
+#define __FUSED_DATASET_HH__
+
+#include "astra-sim/system/DataSet.hh"
+
+namespace AstraSim {
+
+// DataSet of a fused All_Reduce_All_to_All collective. The streams of each
+// pattern report to their own DataSet, and both of them report here.
+class FusedDataSet : public DataSet {
+ public:
+  FusedDataSet(int sys_id, DataSet* all_reduce, DataSet* all_to_all);
+  void call(EventType event, CallData* data);
+  void report();
+
+  int sys_id;
+  DataSet* all_reduce;
+  DataSet* all_to_all;
+  // estimated duration of each pattern on its own, 0 if unknown
+  double all_reduce_alone;
+  double all_to_all_alone;
+};
+
+} // namespace AstraSim
+
+#endif /* __FUSED_DATASET_HH__ */
@@ -10,18 +10,23 @@ using namespace AstraSim;
 PacketBundle::PacketBundle(
     Sys* sys,
     BaseStream* stream,
-    std::list<MyPacket*> locked_packets,
+    PacketQueue* packets,
+    uint64_t first_packet,
+    int packet_count,
     bool needs_processing,
     bool send_back,
     int size,
     MemBus::Transmition transmition) {
   this->sys = sys;
-  this->locked_packets = locked_packets;
+  this->packets = packets;
+  this->first_packet = first_packet;
+  this->packet_count = packet_count;
   this->needs_processing = needs_processing;
   this->send_back = send_back;
   this->size = size;
   this->stream = stream;
   this->transmition = transmition;
+  this->codec_delay = 0;
   creation_time = Sys::boostedTick();
 }
 
@@ -33,11 +38,15 @@ PacketBundle::PacketBundle(
     int size,
     MemBus::Transmition transmition) {
   this->sys = sys;
+  this->packets = nullptr;
+  this->first_packet = 0;
+  this->packet_count = 0;
   this->needs_processing = needs_processing;
   this->send_back = send_back;
   this->size = size;
   this->stream = stream;
   this->transmition = transmition;
+  this->codec_delay = 0;
   creation_time = Sys::boostedTick();
 }
 
@@ -52,19 +61,29 @@ void PacketBundle::send_to_NPU() {
 }
 
 void PacketBundle::call(EventType event, CallData* data) {
-  if (needs_processing == true) {
-    needs_processing = false;
-    this->delay =
-      sys->mem_write(size)
-      + sys->mem_read(size)
-      + sys->mem_read(size);
+  if (needs_processing == true || codec_delay > 0) {
+    // encoding and decoding compressed messages is charged on top of the
+    // reduction
+    this->delay = codec_delay;
+    codec_delay = 0;
+    if (needs_processing == true) {
+      needs_processing = false;
+      this->delay +=
+        sys->mem_write(size)
+        + sys->mem_read(size)
+        + sys->mem_read(size);
+    }
     sys->try_register_event(
         this, EventType::CommProcessingFinished, data, this->delay);
     return;
   }
   Tick current = Sys::boostedTick();
-  for (auto& packet: locked_packets) {
-    packet->ready_time = current;
+  // packets that already left the queue have been sent and need no stamp
+  for (int i = 0; i < packet_count; i++) {
+    PacketDescriptor* packet = packets->find(first_packet + i);
+    if (packet != nullptr) {
+      packet->ready_time = current;
+    }
   }
   stream->call(EventType::General, data);
   delete this;
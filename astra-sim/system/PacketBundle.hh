@@ -10,7 +10,7 @@ LICENSE file in the root directory of this source tree.
 #include "astra-sim/system/Callable.hh"
 #include "astra-sim/system/Common.hh"
 #include "astra-sim/system/MemBus.hh"
-#include "astra-sim/system/MyPacket.hh"
+#include "astra-sim/system/PacketQueue.hh"
 
 namespace AstraSim {
 
@@ -20,7 +20,9 @@ class PacketBundle : public Callable {
   PacketBundle(
       Sys* sys,
       BaseStream* stream,
-      std::list<MyPacket*> locked_packets,
+      PacketQueue* packets,
+      uint64_t first_packet,
+      int packet_count,
       bool needs_processing,
       bool send_back,
       int size,
@@ -37,13 +39,16 @@ class PacketBundle : public Callable {
   void call(EventType event, CallData* data);
 
   Sys* sys;
-  std::list<MyPacket*> locked_packets;
+  PacketQueue* packets;
+  uint64_t first_packet;
+  int packet_count;
   bool needs_processing;
   bool send_back;
   int size;
   BaseStream* stream;
   MemBus::Transmition transmition;
   Tick delay;
+  Tick codec_delay;
   Tick creation_time;
 };
 
@@ -0,0 +1,85 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "astra-sim/system/PacketQueue.hh"
+
+#include "astra-sim/system/Sys.hh"
+
+using namespace AstraSim;
+
+PacketQueue::PacketQueue() {
+  this->head = 0;
+  this->count = 0;
+}
+
+void PacketQueue::reserve(int capacity) {
+  if (capacity <= (int)buffer.size()) {
+    return;
+  }
+  std::vector<PacketDescriptor> resized(capacity);
+  for (uint64_t seq = head; seq < head + count; seq++) {
+    resized[seq % capacity] = buffer[seq % buffer.size()];
+  }
+  buffer.swap(resized);
+}
+
+PacketDescriptor& PacketQueue::push_back(
+    int preferred_vnet,
+    int preferred_src,
+    int preferred_dest,
+    int stream_id,
+    uint64_t msg_size) {
+  if (count == (int)buffer.size()) {
+    reserve(buffer.size() == 0 ? 1 : buffer.size() * 2);
+  }
+  PacketDescriptor& packet = buffer[(head + count) % buffer.size()];
+  packet.preferred_vnet = preferred_vnet;
+  packet.preferred_src = preferred_src;
+  packet.preferred_dest = preferred_dest;
+  packet.stream_id = stream_id;
+  packet.msg_size = msg_size;
+  packet.ready_time = 0;
+  count++;
+  return packet;
+}
+
+PacketDescriptor& PacketQueue::front() {
+  if (count == 0) {
+    Sys::sys_panic("front() called on an empty packet queue");
+  }
+  return buffer[head % buffer.size()];
+}
+
+void PacketQueue::pop_front() {
+  if (count == 0) {
+    Sys::sys_panic("pop_front() called on an empty packet queue");
+  }
+  head++;
+  count--;
+}
+
+PacketDescriptor* PacketQueue::find(uint64_t sequence) {
+  if (sequence < head || sequence >= head + count) {
+    return nullptr;
+  }
+  return &buffer[sequence % buffer.size()];
+}
+
+uint64_t PacketQueue::begin_sequence() {
+  return head;
+}
+
+uint64_t PacketQueue::end_sequence() {
+  return head + count;
+}
+
+int PacketQueue::size() {
+  return count;
+}
+
+void PacketQueue::clear() {
+  head += count;
+  count = 0;
+}
@@ -0,0 +1,58 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#ifndef __PACKET_QUEUE_HH__
+#define __PACKET_QUEUE_HH__
+
+#include <vector>
+
+#include "astra-sim/system/Common.hh"
+
+namespace AstraSim {
+
+// The part of a packet a collective algorithm needs to post its send/recv
+// pair; unlike MyPacket it is not a Callable and is stored by value.
+class PacketDescriptor {
+ public:
+  int preferred_vnet;
+  int preferred_src;
+  int preferred_dest;
+  int stream_id;
+  uint64_t msg_size;
+  Tick ready_time;
+};
+
+// Fixed-capacity FIFO of packet descriptors laid out as a circular buffer.
+// Every descriptor gets a monotonically increasing sequence number, so a
+// PacketBundle can refer to a run of packets by (first, count) without
+// copying them. The buffer only grows if more packets are in flight than
+// the capacity it was reserved with.
+class PacketQueue {
+ public:
+  PacketQueue();
+  void reserve(int capacity);
+  PacketDescriptor& push_back(
+      int preferred_vnet,
+      int preferred_src,
+      int preferred_dest,
+      int stream_id,
+      uint64_t msg_size);
+  PacketDescriptor& front();
+  void pop_front();
+  PacketDescriptor* find(uint64_t sequence);
+  uint64_t begin_sequence();
+  uint64_t end_sequence();
+  int size();
+  void clear();
+
+ private:
+  std::vector<PacketDescriptor> buffer;
+  uint64_t head;
+  int count;
+};
+
+} // namespace AstraSim
+
+#endif /* __PACKET_QUEUE_HH__ */
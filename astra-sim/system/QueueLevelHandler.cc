@@ -47,6 +47,9 @@ std::pair<int, RingTopology::Direction> QueueLevelHandler::
   if (queues.size() == 0) {
     return std::make_pair(-1, dir);
   }
+  if (queues.size() == 1) {
+    return std::make_pair(queues[0], dir);
+  }
   int tmp = queues[first_allocator++];
   if (first_allocator == queues.size() / 2) {
     first_allocator = 0;
@@ -61,6 +64,9 @@ std::pair<int, RingTopology::Direction> QueueLevelHandler::
   if (queues.size() == 0) {
     return std::make_pair(-1, dir);
   }
+  if (queues.size() == 1) {
+    return std::make_pair(queues[0], dir);
+  }
   int tmp = queues[last_allocator++];
   if (last_allocator == queues.size()) {
     last_allocator = queues.size() / 2;
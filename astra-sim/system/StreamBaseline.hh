@@ -6,7 +6,7 @@ LICENSE file in the root directory of this source tree.
 #ifndef __STREAM_BASELINE_HH__
 #define __STREAM_BASELINE_HH__
 
-#include <list>
+#include <vector>
 
 #include "astra-sim/system/BaseStream.hh"
 #include "astra-sim/system/CollectivePhase.hh"
@@ -21,7 +21,7 @@ class StreamBaseline : public BaseStream {
       Sys* owner,
       DataSet* dataset,
       int stream_id,
-      std::list<CollectivePhase> phases_to_go,
+      std::vector<CollectivePhase>&& phases_to_go,
       int priority);
 
   void init();
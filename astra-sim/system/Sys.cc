@@ -5,12 +5,15 @@ LICENSE file in the root directory of this source tree.
 
 #include "astra-sim/system/Sys.hh"
 
+#include <algorithm>
 #include <iostream>
 
 #include "astra-sim/json.hpp"
+#include "astra-sim/system/AllToAllvDataSet.hh"
 #include "astra-sim/system/BaseStream.hh"
 #include "astra-sim/system/CollectivePlan.hh"
 #include "astra-sim/system/DataSet.hh"
+#include "astra-sim/system/FusedDataSet.hh"
 #include "astra-sim/system/MemBus.hh"
 #include "astra-sim/system/QueueLevels.hh"
 #include "astra-sim/system/RendezvousRecvData.hh"
@@ -19,15 +22,26 @@ LICENSE file in the root directory of this source tree.
 #include "astra-sim/system/SimSendCaller.hh"
 #include "astra-sim/system/SendPacketEventHandlerData.hh"
 #include "astra-sim/system/StreamBaseline.hh"
+#include "astra-sim/system/SystemConfig.hh"
 #include "astra-sim/system/WorkloadLayerHandlerData.hh"
 #include "astra-sim/system/MemEventHandlerData.hh"
 #include "astra-sim/system/collective/AllToAll.hh"
+#include "astra-sim/system/collective/BinomialTree.hh"
+#include "astra-sim/system/collective/Chain.hh"
 #include "astra-sim/system/collective/DoubleBinaryTreeAllReduce.hh"
 #include "astra-sim/system/collective/HalvingDoubling.hh"
+#include "astra-sim/system/collective/InNetwork.hh"
 #include "astra-sim/system/collective/Ring.hh"
+#include "astra-sim/system/scheduling/CollectiveAutotuner.hh"
 #include "astra-sim/system/scheduling/OfflineGreedy.hh"
+#include "astra-sim/system/scheduling/PlacementOptimizer.hh"
 #include "astra-sim/system/topology/BasicLogicalTopology.hh"
 #include "astra-sim/system/topology/GeneralComplexTopology.hh"
+#include "astra-sim/system/topology/GraphTopology.hh"
+#include "astra-sim/system/topology/LocalRingGlobalBinaryTree.hh"
+#include "astra-sim/system/topology/LocalRingNodeA2AGlobalDBT.hh"
+#include "astra-sim/system/topology/Torus3D.hh"
+#include "astra-sim/system/topology/TopologyRegistry.hh"
 
 using namespace std;
 using namespace Chakra;
@@ -180,12 +194,17 @@ Sys::Sys(
   this->scheduler_unit = nullptr;
   this->vLevels = nullptr;
   this->offline_greedy = nullptr;
+  this->autotuner = nullptr;
+  this->placement_optimizer = nullptr;
   this->intra_dimension_scheduling = IntraDimensionScheduling::FIFO;
   this->inter_dimension_scheduling = InterDimensionScheduling::Ascending;
   this->round_robin_inter_dimension_scheduler = 0;
   this->active_chunks_per_dimension = 1;
   this->priority_counter = 0;
   this->pending_events = 0;
+  this->scheduled_events = 0;
+  this->created_streams = 0;
+  this->created_phases = 0;
   this->preferred_dataset_splits = 0;
 
   this->last_scheduled_collective = 0;
@@ -196,6 +215,15 @@ Sys::Sys(
   this->communication_delay = 10;
   this->local_reduction_delay = 1;
 
+  this->fuse_all_reduce_all_to_all = false;
+  this->all_to_allv_skew = 0;
+  this->all_to_allv_sequence = 0;
+  this->in_network_reduction_throughput = 0;
+  this->comm_fusion_bucket_size = 0;
+  this->segment_size = 0;
+  this->phase_template_cache = true;
+  this->comm_fusion_window = 0;
+
   if (initialize_sys(system_configuration) == false) {
     sys_panic("Unable to initialize the system layer because the file can not be openned");
   }
@@ -203,16 +231,49 @@ Sys::Sys(
   // scheduler
   int total_disabled = 0;
   this->physical_dims = physical_dims;
-  this->queues_per_dim = queues_per_dim;
-  int element = 0;
+  this->physical_queues_per_dim = queues_per_dim;
+  // the second group of hierarchicalDirect flattens the dimensions after the
+  // one of its entry, so there must be at least one
+  const vector<CollectiveImpl*>& all_to_all_implementation =
+      system_config->all_to_all_implementation_per_dimension;
+  for (int dim = 0; dim < all_to_all_implementation.size(); dim++) {
+    if (all_to_all_implementation[dim]->type !=
+        CollectiveImplType::HierarchicalDirect) {
+      continue;
+    }
+    if (dim + 1 >= physical_dims.size()) {
+      sys_panic(
+          "hierarchicalDirect is the all-to-all implementation of dimension " +
+          to_string(dim) + ", the last dimension of the network: it needs a dimension after its own");
+    }
+    break;
+  }
+  if (rooted_implementation_per_dimension.size() == 0) {
+    // a logical topology file has a single logical dimension
+    int rooted_dims =
+        logical_topology_file != "" ? 1 : physical_dims.size();
+    for (int dim = 0; dim < rooted_dims; dim++) {
+      rooted_implementation_per_dimension.push_back(
+          system_config->default_rooted_implementation);
+    }
+  }
   this->total_nodes = 1;
-  this->dim_to_break = -1;
-  for (int current_dim = 0; current_dim < queues_per_dim.size();
+  for (int current_dim = 0; current_dim < physical_dims.size();
        current_dim++) {
     if (physical_dims[current_dim] >= 1) {
       this->total_nodes *= physical_dims[current_dim];
     }
-    for (int j = 0; j < queues_per_dim[current_dim]; j++) {
+  }
+  // the physical dimensions cut by the parallel groups become several
+  // logical dimensions, each with the queues and the algorithms of its
+  // physical dimension
+  apply_dimension_factorization(
+      system_config->get_dimension_factorization(physical_dims));
+
+  int element = 0;
+  for (int current_dim = 0; current_dim < this->queues_per_dim.size();
+       current_dim++) {
+    for (int j = 0; j < this->queues_per_dim[current_dim]; j++) {
       list<BaseStream*> temp;
       active_Streams[element] = temp;
       list<int> pri;
@@ -221,30 +282,23 @@ Sys::Sys(
     }
   }
 
-  this->concurrent_streams = (int)ceil(((double)active_chunks_per_dimension) / queues_per_dim[0]);
+  this->concurrent_streams = (int)ceil(((double)active_chunks_per_dimension) / this->queues_per_dim[0]);
   this->active_first_phase = 100000000;
   this->max_running = 100000000;
 
   scheduler_unit = new SchedulerUnit(
       this,
-      queues_per_dim,
+      this->queues_per_dim,
       max_running,
       active_first_phase,
       concurrent_streams);
 
-  vLevels = new QueueLevels(queues_per_dim, 0, comm_NI->get_backend_type());
+  vLevels = new QueueLevels(this->queues_per_dim, 0, comm_NI->get_backend_type());
 
   // collective communication
   this->num_streams = 0;
 
-  logical_topologies["AllReduce"] = new GeneralComplexTopology(
-      id, physical_dims, all_reduce_implementation_per_dimension);
-  logical_topologies["ReduceScatter"] = new GeneralComplexTopology(
-      id, physical_dims, reduce_scatter_implementation_per_dimension);
-  logical_topologies["AllGather"] = new GeneralComplexTopology(
-      id, physical_dims, all_gather_implementation_per_dimension);
-  logical_topologies["AllToAll"] = new GeneralComplexTopology(
-      id, physical_dims, all_to_all_implementation_per_dimension);
+  generate_logical_topologies();
 
   memBus = new MemBus(
       "NPU",
@@ -268,8 +322,19 @@ Sys::Sys(
     offline_greedy = new OfflineGreedy(this);
   }
 
+  vector<double> dim_BW;
+  for (int dim = 0; dim < physical_dims.size(); dim++) {
+    dim_BW.push_back(comm_NI->get_BW_at_dimension(dim));
+  }
+  autotuner = system_config->get_collective_autotuner(physical_dims, dim_BW);
+
+  // the volumes of NPU 0 stand for the ones of every rank
+  if (placement_search_output != "" && id == 0) {
+    placement_optimizer = new PlacementOptimizer(this, placement_search_output);
+  }
+
   this->break_dimension_done = false;
-  this->dimension_to_break = 0;
+  this->dimension_to_break = -1;
 
   this->initialized = true;
 }
@@ -287,18 +352,8 @@ Sys::~Sys() {
 
   logical_topologies.clear();
 
-  for (auto ci : all_reduce_implementation_per_dimension) {
-    delete ci;
-  }
-  for (auto ci : reduce_scatter_implementation_per_dimension) {
-    delete ci;
-  }
-  for (auto ci : all_gather_implementation_per_dimension) {
-    delete ci;
-  }
-  for (auto ci : all_to_all_implementation_per_dimension) {
-    delete ci;
-  }
+  // the collective implementations and the autotuner are owned by the
+  // shared SystemConfig
 
   if (scheduler_unit != nullptr)
     delete scheduler_unit;
@@ -315,6 +370,11 @@ Sys::~Sys() {
   if (offline_greedy != nullptr)
     delete offline_greedy;
 
+  if (placement_optimizer != nullptr)
+    delete placement_optimizer;
+
+  clear_phase_templates();
+
   bool shouldExit = true;
   for (auto& a : all_sys) {
     if (a != nullptr) {
@@ -324,22 +384,16 @@ Sys::~Sys() {
   }
 
   if (shouldExit) {
+    TopologyRegistry::clear();
+    SystemConfig::clear();
     exit_sim_loop("Exiting");
   }
 }
 
 bool Sys::initialize_sys(string name) {
-  ifstream inFile;
-  inFile.open(name);
-  if (!inFile) {
-    if (id == 0) {
-      cerr << "Unable to open file: " << name << endl;
-    }
-    exit(1);
-  }
-
-  json j;
-  inFile >> j;
+  // the file is parsed once and shared with the other NPUs
+  system_config = SystemConfig::get_system_config(name);
+  const json& j = system_config->j;
   if (j.contains("scheduling-policy")) {
     string inp_scheduling_policy = j["scheduling-policy"];
     if (inp_scheduling_policy == "LIFO") {
@@ -352,34 +406,16 @@ bool Sys::initialize_sys(string name) {
       sys_panic("unknown value for scheduling policy in sys input file");
     }
   }
-  if (j.contains("all-reduce-implementation")) {
-    vector<string> collective_impl_str_vec = j["all-reduce-implementation"];
-    for (auto collective_impl_str: collective_impl_str_vec) {
-      CollectiveImpl* ci = generate_collective_impl_from_input(collective_impl_str);
-      all_reduce_implementation_per_dimension.push_back(ci);
-    }
-  }
-  if (j.contains("reduce-scatter-implementation")) {
-    vector<string> collective_impl_str_vec = j["reduce-scatter-implementation"];
-    for (auto collective_impl_str: collective_impl_str_vec) {
-      CollectiveImpl* ci = generate_collective_impl_from_input(collective_impl_str);
-      reduce_scatter_implementation_per_dimension.push_back(ci);
-    }
-  }
-  if (j.contains("all-gather-implementation")) {
-    vector<string> collective_impl_str_vec = j["all-gather-implementation"];
-    for (auto collective_impl_str: collective_impl_str_vec) {
-      CollectiveImpl* ci = generate_collective_impl_from_input(collective_impl_str);
-      all_gather_implementation_per_dimension.push_back(ci);
-    }
-  }
-  if (j.contains("all-to-all-implementation")) {
-    vector<string> collective_impl_str_vec = j["all-to-all-implementation"];
-    for (auto collective_impl_str: collective_impl_str_vec) {
-      CollectiveImpl* ci = generate_collective_impl_from_input(collective_impl_str);
-      all_to_all_implementation_per_dimension.push_back(ci);
-    }
-  }
+  all_reduce_implementation_per_dimension =
+      system_config->all_reduce_implementation_per_dimension;
+  reduce_scatter_implementation_per_dimension =
+      system_config->reduce_scatter_implementation_per_dimension;
+  all_gather_implementation_per_dimension =
+      system_config->all_gather_implementation_per_dimension;
+  all_to_all_implementation_per_dimension =
+      system_config->all_to_all_implementation_per_dimension;
+  rooted_implementation_per_dimension =
+      system_config->rooted_implementation_per_dimension;
   if (j.contains("collective-optimization")) {
     string inp_collective_optimization = j["collective-optimization"];
     if (inp_collective_optimization == "baseline") {
@@ -439,6 +475,90 @@ bool Sys::initialize_sys(string name) {
       roofline = new Roofline(local_mem_bw, peak_perf);
     }
   }
+  if (j.contains("fuse-all-reduce-all-to-all")) {
+    if (j["fuse-all-reduce-all-to-all"] != 0) {
+      fuse_all_reduce_all_to_all = true;
+    }
+  }
+  if (j.contains("compression-ratio")) {
+    vector<double> ratio = j["compression-ratio"];
+    compression_per_dimension.resize(max(compression_per_dimension.size(), ratio.size()));
+    for (int dim = 0; dim < ratio.size(); dim++) {
+      if (ratio[dim] <= 0) {
+        sys_panic("compression ratio should be larger than 0");
+      }
+      compression_per_dimension[dim].ratio = ratio[dim];
+    }
+  }
+  if (j.contains("compression-encode-cost")) {
+    vector<double> encode_cost = j["compression-encode-cost"];
+    compression_per_dimension.resize(max(compression_per_dimension.size(), encode_cost.size()));
+    for (int dim = 0; dim < encode_cost.size(); dim++) {
+      compression_per_dimension[dim].encode_cost = encode_cost[dim];
+    }
+  }
+  if (j.contains("compression-decode-cost")) {
+    vector<double> decode_cost = j["compression-decode-cost"];
+    compression_per_dimension.resize(max(compression_per_dimension.size(), decode_cost.size()));
+    for (int dim = 0; dim < decode_cost.size(); dim++) {
+      compression_per_dimension[dim].decode_cost = decode_cost[dim];
+    }
+  }
+  if (j.contains("compression-survives-reduction")) {
+    vector<int> survives_reduction = j["compression-survives-reduction"];
+    compression_per_dimension.resize(
+        max(compression_per_dimension.size(), survives_reduction.size()));
+    for (int dim = 0; dim < survives_reduction.size(); dim++) {
+      compression_per_dimension[dim].survives_reduction = survives_reduction[dim] != 0;
+    }
+  }
+  if (j.contains("injection-policy")) {
+    vector<string> injection_policy_str_vec = j["injection-policy"];
+    for (auto injection_policy_str : injection_policy_str_vec) {
+      injection_policy_per_dimension.push_back(
+          generate_injection_policy_from_input(injection_policy_str));
+    }
+  }
+  if (j.contains("packet-routing")) {
+    vector<string> packet_routing_str_vec = j["packet-routing"];
+    for (auto packet_routing_str : packet_routing_str_vec) {
+      if (packet_routing_str == "hardware") {
+        packet_routing_per_dimension.push_back(PacketRouting::Hardware);
+      } else if (packet_routing_str == "software") {
+        packet_routing_per_dimension.push_back(PacketRouting::Software);
+      } else {
+        sys_panic("unknown value for packet routing in sys input file");
+      }
+    }
+  }
+  if (j.contains("segment-size")) {
+    segment_size = j["segment-size"];
+  }
+  if (j.contains("collective-phase-cache")) {
+    if (j["collective-phase-cache"] == 0) {
+      phase_template_cache = false;
+    }
+  }
+  if (j.contains("comm-fusion-bucket-size")) {
+    comm_fusion_bucket_size = j["comm-fusion-bucket-size"];
+  }
+  if (j.contains("comm-fusion-window")) {
+    comm_fusion_window = j["comm-fusion-window"];
+  }
+  if (j.contains("placement-search-output")) {
+    string inp_placement_search_output = j["placement-search-output"];
+    placement_search_output = inp_placement_search_output;
+  }
+  if (j.contains("logical-topology-file")) {
+    string inp_logical_topology_file = j["logical-topology-file"];
+    logical_topology_file = inp_logical_topology_file;
+  }
+  if (j.contains("in-network-reduction-throughput")) {
+    in_network_reduction_throughput = j["in-network-reduction-throughput"];
+  }
+  if (j.contains("all-to-allv-skew")) {
+    all_to_allv_skew = j["all-to-allv-skew"];
+  }
   this->trace_enabled = false;
   if (j.contains("trace-enabled")) {
     if (j["trace-enabled"] != 0) {
@@ -448,15 +568,152 @@ bool Sys::initialize_sys(string name) {
     }
   }
 
-  inFile.close();
   return true;
 }
 
+void Sys::generate_logical_topologies() {
+  logical_topologies["AllReduce"] = generate_logical_topology(
+      "AllReduce", all_reduce_implementation_per_dimension);
+  logical_topologies["ReduceScatter"] = generate_logical_topology(
+      "ReduceScatter", reduce_scatter_implementation_per_dimension);
+  logical_topologies["AllGather"] = generate_logical_topology(
+      "AllGather", all_gather_implementation_per_dimension);
+  logical_topologies["AllToAll"] = generate_logical_topology(
+      "AllToAll", all_to_all_implementation_per_dimension);
+  logical_topologies["Rooted"] = generate_logical_topology(
+      "Rooted", rooted_implementation_per_dimension);
+}
+
+void Sys::apply_dimension_factorization(
+    const DimensionFactorization& factorization) {
+  logical_dims = factorization.logical_dims;
+  logical_to_physical_dim = factorization.physical_dim;
+  queues_per_dim.clear();
+  for (int dim : logical_to_physical_dim) {
+    queues_per_dim.push_back(physical_queues_per_dim[dim]);
+  }
+  if (logical_dims.size() == physical_dims.size()) {
+    return;
+  }
+  if (!system_config->composite_topologies.empty() ||
+      logical_topology_file != "") {
+    sys_panic("the parallel groups should cover whole dimensions when a composite implementation or a logical topology file is used");
+  }
+  all_reduce_implementation_per_dimension =
+      get_logical_implementation(all_reduce_implementation_per_dimension);
+  reduce_scatter_implementation_per_dimension =
+      get_logical_implementation(reduce_scatter_implementation_per_dimension);
+  all_gather_implementation_per_dimension =
+      get_logical_implementation(all_gather_implementation_per_dimension);
+  all_to_all_implementation_per_dimension =
+      get_logical_implementation(all_to_all_implementation_per_dimension);
+  rooted_implementation_per_dimension =
+      get_logical_implementation(rooted_implementation_per_dimension);
+}
+
+// The implementation of each logical dimension is the one of its physical
+// dimension. The entries past the physical dimensions (the second logical
+// dimension of hierarchicalDirect) are kept at the end.
+vector<CollectiveImpl*> Sys::get_logical_implementation(
+    const vector<CollectiveImpl*>& implementation_per_physical_dimension) {
+  vector<CollectiveImpl*> implementation_per_dimension;
+  for (int dim : logical_to_physical_dim) {
+    if (dim < implementation_per_physical_dimension.size()) {
+      implementation_per_dimension.push_back(
+          implementation_per_physical_dimension[dim]);
+    }
+  }
+  for (int dim = physical_dims.size();
+       dim < implementation_per_physical_dimension.size();
+       dim++) {
+    implementation_per_dimension.push_back(
+        implementation_per_physical_dimension[dim]);
+  }
+  return implementation_per_dimension;
+}
+
+int Sys::get_physical_dimension(int dim) {
+  if (dim < logical_to_physical_dim.size()) {
+    return logical_to_physical_dim[dim];
+  }
+  return dim;
+}
+
+LogicalTopology* Sys::generate_logical_topology(
+    string name,
+    const vector<CollectiveImpl*>& implementation_per_dimension) {
+  if (logical_topology_file != "") {
+    TopologyGraph* graph =
+        TopologyRegistry::get_topology_graph(logical_topology_file);
+    if (graph->npus != total_nodes) {
+      sys_panic("the number of NPUs of the logical topology file does not match the network");
+    }
+    if (implementation_per_dimension.size() != 1) {
+      sys_panic("a logical topology file takes exactly one implementation per collective");
+    }
+    CollectiveImplType type = implementation_per_dimension[0]->type;
+    if (type != CollectiveImplType::Ring &&
+        type != CollectiveImplType::MultiChannelRing &&
+        type != CollectiveImplType::Direct &&
+        type != CollectiveImplType::HalvingDoubling &&
+        type != CollectiveImplType::DoubleBinaryTree &&
+        type != CollectiveImplType::Chain &&
+        type != CollectiveImplType::BinomialTree) {
+      sys_panic("a logical topology file supports the ring, direct, halvingDoubling, doubleBinaryTree, chain and binomialTree implementations");
+    }
+    if ((type == CollectiveImplType::DoubleBinaryTree ||
+         type == CollectiveImplType::HalvingDoubling) &&
+        (total_nodes & (total_nodes - 1)) != 0) {
+      sys_panic("doubleBinaryTree and halvingDoubling on a logical topology file need a power of 2 number of NPUs");
+    }
+    return new GraphTopology(id, graph, implementation_per_dimension[0]);
+  }
+  auto composite = system_config->composite_topologies.find(name);
+  if (composite == system_config->composite_topologies.end()) {
+    return new GeneralComplexTopology(
+        id, logical_dims, implementation_per_dimension);
+  }
+  if (physical_dims.size() != 3) {
+    sys_panic("hierarchicalRing, doubleBinaryTreeLocalAllToAll and localRingNodeA2AGlobalDBT need a 3-dimensional network");
+  }
+  if (composite->second == CollectiveImplType::HierarchicalRing) {
+    return new Torus3D(id, total_nodes, physical_dims[0], physical_dims[2]);
+  } else if (
+      composite->second == CollectiveImplType::DoubleBinaryTreeLocalAllToAll) {
+    // two trees across the NPUs that share the same local index, which the
+    // all-reduce phases take in turns
+    return new LocalRingGlobalBinaryTree(
+        id,
+        physical_dims[0],
+        total_nodes / physical_dims[0],
+        id % physical_dims[0],
+        physical_dims[0]);
+  } else {
+    int node_size = physical_dims[0] * physical_dims[1];
+    return new LocalRingNodeA2AGlobalDBT(
+        id,
+        physical_dims[0],
+        physical_dims[1],
+        physical_dims[2],
+        id % node_size,
+        node_size);
+  }
+}
+
 CollectiveImpl* Sys::generate_collective_impl_from_input(string collective_impl_str) {
   if (collective_impl_str == "ring") {
     return new CollectiveImpl(CollectiveImplType::Ring);
+  } else if (collective_impl_str.rfind("ring:", 0) == 0) {
+    int channels = get_implementation_parameter(collective_impl_str, 5);
+    if (channels < 1) {
+      sys_panic("the number of channels of a multi-channel ring should be at least 1");
+    }
+    return new MultiChannelCollectiveImpl(
+        CollectiveImplType::MultiChannelRing, channels);
   } else if (collective_impl_str == "oneRing") {
     return new CollectiveImpl(CollectiveImplType::OneRing);
+  } else if (collective_impl_str == "oneRingSnake") {
+    return new CollectiveImpl(CollectiveImplType::OneRingSnake);
   } else if (collective_impl_str == "doubleBinaryTree") {
     return new CollectiveImpl(CollectiveImplType::DoubleBinaryTree);
   } else if (collective_impl_str.rfind("direct", 0) == 0) {
@@ -465,6 +722,12 @@ CollectiveImpl* Sys::generate_collective_impl_from_input(string collective_impl_
       window = stoi(collective_impl_str.substr(6, 5));
     }
     return new DirectCollectiveImpl(CollectiveImplType::Direct, window);
+  } else if (collective_impl_str.rfind("hierarchicalDirect", 0) == 0) {
+    int window = -1;
+    if (collective_impl_str != "hierarchicalDirect") {
+      window = get_implementation_parameter(collective_impl_str, 18);
+    }
+    return new DirectCollectiveImpl(CollectiveImplType::HierarchicalDirect, window);
   } else if (collective_impl_str.rfind("oneDirect", 0) == 0) {
     int window = -1;
     if (collective_impl_str != "oneDirect") {
@@ -475,6 +738,19 @@ CollectiveImpl* Sys::generate_collective_impl_from_input(string collective_impl_
     return new CollectiveImpl(CollectiveImplType::HalvingDoubling);
   } else if (collective_impl_str == "oneHalvingDoubling") {
     return new CollectiveImpl(CollectiveImplType::OneHalvingDoubling);
+  } else if (collective_impl_str == "hierarchicalRing") {
+    return new CollectiveImpl(CollectiveImplType::HierarchicalRing);
+  } else if (collective_impl_str == "doubleBinaryTreeLocalAllToAll") {
+    return new CollectiveImpl(
+        CollectiveImplType::DoubleBinaryTreeLocalAllToAll);
+  } else if (collective_impl_str == "localRingNodeA2AGlobalDBT") {
+    return new CollectiveImpl(CollectiveImplType::LocalRingNodeA2AGlobalDBT);
+  } else if (collective_impl_str == "inNetwork") {
+    return new CollectiveImpl(CollectiveImplType::InNetwork);
+  } else if (collective_impl_str == "chain") {
+    return new CollectiveImpl(CollectiveImplType::Chain);
+  } else if (collective_impl_str == "binomialTree") {
+    return new CollectiveImpl(CollectiveImplType::BinomialTree);
   } else {
     sys_panic(
         "Cannot interpret collective implementations. Please check the collective implementations in the sys"
@@ -483,6 +759,47 @@ CollectiveImpl* Sys::generate_collective_impl_from_input(string collective_impl_
   }
 }
 
+// The number that follows the name of an implementation (e.g. the K of
+// ring:K).
+int Sys::get_implementation_parameter(
+    string collective_impl_str,
+    int name_length) {
+  string parameter = collective_impl_str.substr(name_length);
+  size_t parsed = 0;
+  int value = 0;
+  try {
+    value = stoi(parameter, &parsed);
+  } catch (...) {
+    parsed = 0;
+  }
+  if (parsed == 0 || parsed != parameter.size()) {
+    sys_panic(
+        "Cannot interpret the collective implementation " +
+        collective_impl_str + ": \"" + parameter + "\" is not a number");
+  }
+  return value;
+}
+
+InjectionPolicy Sys::generate_injection_policy_from_input(
+    string injection_policy_str) {
+  if (injection_policy_str == "normal") {
+    return InjectionPolicy::Normal;
+  } else if (injection_policy_str == "semiAggressive") {
+    return InjectionPolicy::SemiAggressive;
+  } else if (injection_policy_str == "aggressive") {
+    return InjectionPolicy::Aggressive;
+  } else if (injection_policy_str == "extraAggressive") {
+    return InjectionPolicy::ExtraAggressive;
+  } else if (injection_policy_str == "infinite") {
+    return InjectionPolicy::Infinite;
+  } else {
+    sys_panic(
+        "Cannot interpret injection policy. Please check the injection policies in the sys"
+        "input file");
+    return InjectionPolicy::Normal;
+  }
+}
+
 Tick Sys::boostedTick() {
   Sys* ts = all_sys[0];
   if (ts == nullptr) {
@@ -557,6 +874,7 @@ void Sys::try_register_event(
   }
   cycles = 0;
   pending_events++;
+  scheduled_events++;
   return;
 }
 
@@ -627,12 +945,14 @@ Tick Sys::mem_write(uint64_t bytes) {
 LogicalTopology* Sys::get_logical_topology(ComType comm_type){
   if(comm_type==ComType::All_Reduce)
     return logical_topologies["AllReduce"];
-  else if(comm_type==ComType::All_to_All)
+  else if(comm_type==ComType::All_to_All || comm_type==ComType::All_to_Allv)
     return logical_topologies["AllToAll"];
   else if(comm_type==ComType::Reduce_Scatter)
       return logical_topologies["ReduceScatter"];
   else if(comm_type==ComType::All_Gather)
     return logical_topologies["AllGather"];
+  else if(is_rooted_collective(comm_type))
+    return logical_topologies["Rooted"];
   else{
     sys_panic("no known logical topology!");
     return nullptr;
@@ -642,12 +962,14 @@ LogicalTopology* Sys::get_logical_topology(ComType comm_type){
 vector<CollectiveImpl*> Sys::get_collective_implementation(ComType comm_type) {
   if(comm_type==ComType::All_Reduce)
     return all_reduce_implementation_per_dimension;
-  else if(comm_type==ComType::All_to_All)
+  else if(comm_type==ComType::All_to_All || comm_type==ComType::All_to_Allv)
     return all_to_all_implementation_per_dimension;
   else if(comm_type==ComType::Reduce_Scatter)
     return reduce_scatter_implementation_per_dimension;
   else if(comm_type==ComType::All_Gather)
     return all_gather_implementation_per_dimension;
+  else if(is_rooted_collective(comm_type))
+    return rooted_implementation_per_dimension;
   else{
     sys_panic("no known collective implementation!");
     vector<CollectiveImpl*> tmp;
@@ -657,7 +979,7 @@ vector<CollectiveImpl*> Sys::get_collective_implementation(ComType comm_type) {
 
 DataSet* Sys::generate_all_reduce(
     uint64_t size,
-    vector<bool> involved_dimensions,
+    const vector<bool>& involved_dimensions,
     CommunicatorGroup *communicator_group,
     int explicit_priority) {
   if (communicator_group == nullptr) {
@@ -685,7 +1007,7 @@ DataSet* Sys::generate_all_reduce(
 
 DataSet* Sys::generate_all_to_all(
     uint64_t size,
-    vector<bool> involved_dimensions,
+    const vector<bool>& involved_dimensions,
     CommunicatorGroup *communicator_group,
     int explicit_priority) {
   if (communicator_group == nullptr) {
@@ -711,9 +1033,48 @@ DataSet* Sys::generate_all_to_all(
   }
 }
 
+DataSet* Sys::generate_all_to_allv(
+    uint64_t size,
+    const vector<bool>& involved_dimensions,
+    CommunicatorGroup *communicator_group,
+    int explicit_priority) {
+  DataSet* all_to_allv = nullptr;
+  int participants = total_nodes;
+  // the NPUs of a group agree on the sequence number of its collectives
+  // whatever the other groups they take part in
+  int group_id = communicator_group == nullptr ? -1 : communicator_group->get_id();
+  all_to_allv_sequence = all_to_allv_sequence_per_group[group_id]++;
+  if (communicator_group == nullptr) {
+    all_to_allv = generate_collective(
+        size,
+        logical_topologies["AllToAll"],
+        all_to_all_implementation_per_dimension,
+        involved_dimensions,
+        ComType::All_to_Allv,
+        explicit_priority,
+        communicator_group);
+  } else {
+    CollectivePlan *plan
+      = communicator_group->get_collective_plan(ComType::All_to_Allv);
+    all_to_allv = generate_collective(
+        size,
+        plan->topology,
+        plan->implementation_per_dimension,
+        plan->dimensions_involved,
+        ComType::All_to_Allv,
+        explicit_priority,
+        communicator_group);
+    participants = communicator_group->involved_NPUs.size();
+  }
+  // the phases of this collective have been generated with the current
+  // sequence number, which seeds the per-peer message sizes
+  return new AllToAllvDataSet(
+      id, group_id, all_to_allv_sequence, participants, all_to_allv);
+}
+
 DataSet* Sys::generate_all_gather(
     uint64_t size,
-    vector<bool> involved_dimensions,
+    const vector<bool>& involved_dimensions,
     CommunicatorGroup *communicator_group,
     int explicit_priority) {
   if (communicator_group == nullptr) {
@@ -741,7 +1102,7 @@ DataSet* Sys::generate_all_gather(
 
 DataSet* Sys::generate_reduce_scatter(
     uint64_t size,
-    vector<bool> involved_dimensions,
+    const vector<bool>& involved_dimensions,
     CommunicatorGroup *communicator_group,
     int explicit_priority) {
   if (communicator_group == nullptr) {
@@ -767,18 +1128,251 @@ DataSet* Sys::generate_reduce_scatter(
   }
 }
 
+DataSet* Sys::generate_all_reduce_all_to_all(
+    uint64_t all_reduce_size,
+    uint64_t all_to_all_size,
+    const vector<bool>& all_reduce_involved_dimensions,
+    const vector<bool>& all_to_all_involved_dimensions,
+    CommunicatorGroup *communicator_group,
+    int explicit_priority) {
+  LogicalTopology* all_reduce_topology = logical_topologies["AllReduce"];
+  const vector<CollectiveImpl*>* all_reduce_implementation =
+    &all_reduce_implementation_per_dimension;
+  const vector<bool>* all_reduce_dimensions = &all_reduce_involved_dimensions;
+  LogicalTopology* all_to_all_topology = logical_topologies["AllToAll"];
+  const vector<CollectiveImpl*>* all_to_all_implementation =
+    &all_to_all_implementation_per_dimension;
+  const vector<bool>* all_to_all_dimensions = &all_to_all_involved_dimensions;
+  if (communicator_group != nullptr) {
+    CollectivePlan *plan
+      = communicator_group->get_collective_plan(ComType::All_Reduce);
+    all_reduce_topology = plan->topology;
+    all_reduce_implementation = &plan->implementation_per_dimension;
+    all_reduce_dimensions = &plan->dimensions_involved;
+    plan = communicator_group->get_collective_plan(ComType::All_to_All);
+    all_to_all_topology = plan->topology;
+    all_to_all_implementation = &plan->implementation_per_dimension;
+    all_to_all_dimensions = &plan->dimensions_involved;
+  }
+  // each pattern is chunked on its own size; the all-reduce streams take
+  // the clockwise queues and the all-to-all streams the anticlockwise ones
+  // so that they do not contend on the same queues
+  DataSet* all_reduce = generate_collective(
+      all_reduce_size,
+      all_reduce_topology,
+      *all_reduce_implementation,
+      *all_reduce_dimensions,
+      ComType::All_Reduce,
+      explicit_priority,
+      communicator_group,
+      0);
+  DataSet* all_to_all = generate_collective(
+      all_to_all_size,
+      all_to_all_topology,
+      *all_to_all_implementation,
+      *all_to_all_dimensions,
+      ComType::All_to_All,
+      explicit_priority,
+      communicator_group,
+      1);
+  FusedDataSet* fused = new FusedDataSet(id, all_reduce, all_to_all);
+  // the back-to-back baseline needs each pattern on its own, which the fused
+  // run never shows since both patterns contend from the start
+  fused->all_reduce_alone = estimate_isolated_time(
+      all_reduce_topology,
+      *all_reduce_dimensions,
+      ComType::All_Reduce,
+      all_reduce_size);
+  fused->all_to_all_alone = estimate_isolated_time(
+      all_to_all_topology,
+      *all_to_all_dimensions,
+      ComType::All_to_All,
+      all_to_all_size);
+  return fused;
+}
+
+// Contention-free bandwidth time of a collective that runs hierarchically
+// over the involved dimensions of a topology. Latencies and the reduction
+// are left out, so it never exceeds the time the collective takes alone.
+// 0 if the bandwidth of a dimension is unknown.
+double Sys::estimate_isolated_time(
+    LogicalTopology* topology,
+    const vector<bool>& dimensions_involved,
+    ComType collective_type,
+    uint64_t size) {
+  vector<pair<int, double>> dimensions;
+  for (int dim = 0; dim < topology->get_num_of_dimensions(); dim++) {
+    int nodes = topology->get_num_of_nodes_in_dimension(dim);
+    if (dim >= dimensions_involved.size() || !dimensions_involved[dim] ||
+        nodes < 2) {
+      continue;
+    }
+    double bw = comm_NI->get_BW_at_dimension(get_physical_dimension(dim));
+    if (bw <= 0) {
+      return 0;
+    }
+    dimensions.push_back(make_pair(nodes, bw));
+  }
+  return estimate_hierarchical_time(dimensions, collective_type, size);
+}
+
+// Bandwidth cost of a collective that runs hierarchically over (nodes,
+// bandwidth) dimensions, innermost first. Reductions shrink the data by the
+// size of every dimension they leave behind; an all-to-all moves all of it
+// on every dimension.
+double Sys::estimate_hierarchical_time(
+    const vector<pair<int, double>>& dimensions,
+    ComType collective_type,
+    double size) {
+  double time = 0;
+  double remaining = size;
+  for (auto& dimension : dimensions) {
+    double p = dimension.first;
+    double bw = dimension.second;
+    if (collective_type == ComType::All_Reduce) {
+      time += 2 * (p - 1) / p * remaining / bw;
+      remaining /= p;
+    } else if (
+        collective_type == ComType::All_to_All ||
+        collective_type == ComType::All_to_Allv) {
+      time += (p - 1) / p * size / bw;
+    } else {
+      time += (p - 1) / p * remaining / bw;
+      remaining /= p;
+    }
+  }
+  return time;
+}
+
+DataSet* Sys::generate_broadcast(
+    uint64_t size,
+    int root,
+    const vector<bool>& involved_dimensions,
+    CommunicatorGroup *communicator_group,
+    int explicit_priority) {
+  return generate_rooted_collective(
+      size,
+      root,
+      involved_dimensions,
+      ComType::Broadcast,
+      communicator_group,
+      explicit_priority);
+}
+
+DataSet* Sys::generate_reduce(
+    uint64_t size,
+    int root,
+    const vector<bool>& involved_dimensions,
+    CommunicatorGroup *communicator_group,
+    int explicit_priority) {
+  return generate_rooted_collective(
+      size,
+      root,
+      involved_dimensions,
+      ComType::Reduce,
+      communicator_group,
+      explicit_priority);
+}
+
+DataSet* Sys::generate_gather(
+    uint64_t size,
+    int root,
+    const vector<bool>& involved_dimensions,
+    CommunicatorGroup *communicator_group,
+    int explicit_priority) {
+  return generate_rooted_collective(
+      size,
+      root,
+      involved_dimensions,
+      ComType::Gather,
+      communicator_group,
+      explicit_priority);
+}
+
+DataSet* Sys::generate_scatter(
+    uint64_t size,
+    int root,
+    const vector<bool>& involved_dimensions,
+    CommunicatorGroup *communicator_group,
+    int explicit_priority) {
+  return generate_rooted_collective(
+      size,
+      root,
+      involved_dimensions,
+      ComType::Scatter,
+      communicator_group,
+      explicit_priority);
+}
+
+DataSet* Sys::generate_barrier(
+    const vector<bool>& involved_dimensions,
+    CommunicatorGroup *communicator_group,
+    int explicit_priority) {
+  // a barrier is a reduce to NPU 0 followed by a broadcast from it, both
+  // carrying a small token
+  return generate_rooted_collective(
+      barrier_token_size,
+      0,
+      involved_dimensions,
+      ComType::Barrier,
+      communicator_group,
+      explicit_priority);
+}
+
+DataSet* Sys::generate_rooted_collective(
+    uint64_t size,
+    int root,
+    const vector<bool>& involved_dimensions,
+    ComType collective_type,
+    CommunicatorGroup *communicator_group,
+    int explicit_priority) {
+  if (communicator_group == nullptr) {
+    return generate_collective(
+        size,
+        logical_topologies["Rooted"],
+        rooted_implementation_per_dimension,
+        involved_dimensions,
+        collective_type,
+        explicit_priority,
+        communicator_group,
+        -1,
+        root);
+  } else {
+    CollectivePlan *plan
+      = communicator_group->get_collective_plan(collective_type);
+    return generate_collective(
+        size,
+        plan->topology,
+        plan->implementation_per_dimension,
+        plan->dimensions_involved,
+        collective_type,
+        explicit_priority,
+        communicator_group,
+        -1,
+        root);
+  }
+}
+
 DataSet* Sys::generate_collective(
     uint64_t size,
     LogicalTopology* topology,
-    vector<CollectiveImpl*> implementation_per_dimension,
-    vector<bool> dimensions_involved,
+    const vector<CollectiveImpl*>& implementation_per_dimension,
+    const vector<bool>& dimensions_involved,
     ComType collective_type,
     int explicit_priority,
-    CommunicatorGroup *communicator_group) {
+    CommunicatorGroup *communicator_group,
+    int queue_channel,
+    int root) {
+  if (placement_optimizer != nullptr) {
+    placement_optimizer->add_collective(
+        communicator_group == nullptr ? -1 : communicator_group->get_id(),
+        collective_type,
+        size);
+  }
   uint64_t chunk_size = determine_chunk_size(size, collective_type);
   uint64_t recommended_chunk_size = chunk_size;
   int streams = ceil(((double)size) / chunk_size);
-  int tmp;
+  uint64_t tmp;
   DataSet* dataset = new DataSet(streams);
   int pri = get_priority(explicit_priority);
   int count = 0;
@@ -791,9 +1385,24 @@ DataSet* Sys::generate_collective(
     }
   }
 
-  while (size > 0) {
-    count++;
+  // a chunk is split into as many channels as the widest multi-channel
+  // ring among the involved dimensions asks for
+  int channels = 1;
+  for (int dim = 0; dim < topology->get_num_of_dimensions(); dim++) {
+    if (topology->get_num_of_nodes_in_dimension(dim) == 1 ||
+        !dimensions_involved[dim]) {
+      continue;
+    }
+    if (implementation_per_dimension[dim]->type ==
+        CollectiveImplType::MultiChannelRing) {
+      channels = max(
+          channels,
+          ((MultiChannelCollectiveImpl*)implementation_per_dimension[dim])
+              ->channels);
+    }
+  }
 
+  while (size > 0) {
     vector<int> dim_mapper(topology->get_num_of_dimensions());
     iota(begin(dim_mapper), end(dim_mapper), 0);
     if (collective_type == ComType::All_Gather) {
@@ -812,6 +1421,8 @@ DataSet* Sys::generate_collective(
       }
     } else if (
         collective_type != ComType::All_to_All &&
+        collective_type != ComType::All_to_Allv &&
+        !is_rooted_collective(collective_type) &&
         (inter_dimension_scheduling == InterDimensionScheduling::OfflineGreedy ||
          inter_dimension_scheduling == InterDimensionScheduling::OfflineGreedyFlex)) {
       uint64_t prev_size = size;
@@ -826,166 +1437,443 @@ DataSet* Sys::generate_collective(
     }
 
     if (collective_type == ComType::All_to_All ||
+        collective_type == ComType::All_to_Allv ||
+        is_rooted_collective(collective_type) ||
         (inter_dimension_scheduling != InterDimensionScheduling::OfflineGreedy &&
          inter_dimension_scheduling != InterDimensionScheduling::OfflineGreedyFlex)) {
       size -= chunk_size;
     }
-    tmp = chunk_size;
-    list<CollectivePhase> vect;
-
-    if (collective_type != ComType::All_Reduce ||
-        collectiveOptimization == CollectiveOptimization::Baseline) {
-      for (int dim = 0; dim < topology->get_num_of_dimensions(); dim++) {
-        if (topology->get_num_of_nodes_in_dimension(dim_mapper[dim]) == 1 ||
-            !dimensions_involved[dim_mapper[dim]]) {
-          continue;
-        }
-        pair<int, RingTopology::Direction> queue =
-            vLevels->get_next_queue_at_level(dim_mapper[dim]);
-        CollectivePhase phase = generate_collective_phase(
-            collective_type,
-            topology->get_basic_topology_at_dimension(
-                dim_mapper[dim], collective_type),
-            tmp,
-            queue.first,
-            queue.second,
-            InjectionPolicy::Normal,
-            implementation_per_dimension[dim_mapper[dim]]);
-        vect.push_back(phase);
-        tmp = phase.final_data_size;
+    if (chunk_size < (uint64_t)channels) {
+      sys_panic(
+          "a chunk of " + to_string(chunk_size) + " bytes cannot be split into " +
+          to_string(channels) + " ring channels; use fewer channels");
+    }
+    for (int channel = 0; channel < channels; channel++) {
+      tmp = chunk_size / channels;
+      if (channel == channels - 1) {
+        tmp = chunk_size - (channels - 1) * (chunk_size / channels);
       }
-    } else if (
-        inter_dimension_scheduling == InterDimensionScheduling::OfflineGreedy ||
-        inter_dimension_scheduling == InterDimensionScheduling::OfflineGreedyFlex ||
-        inter_dimension_scheduling == InterDimensionScheduling::OnlineGreedy) {
-      int dim = 0;
-      for (dim = 0; dim < topology->get_num_of_dimensions(); dim++) {
-        if (topology->get_num_of_nodes_in_dimension(dim_mapper[dim]) == 1 ||
-            !dimensions_involved[dim_mapper[dim]]) {
-          continue;
+      vector<CollectivePhase> vect = generate_collective_phases(
+          topology,
+          implementation_per_dimension,
+          dimensions_involved,
+          dim_mapper,
+          collective_type,
+          tmp,
+          queue_channel >= 0 ? queue_channel : (channels > 1 ? channel : -1),
+          root);
+      if (vect.size() > 0) {
+        count++;
+        created_streams++;
+        created_phases += vect.size();
+        int stream_id = num_streams++;
+        if (communicator_group != nullptr) {
+          stream_id = communicator_group->num_streams++;
         }
-        pair<int, RingTopology::Direction> queue =
-            vLevels->get_next_queue_at_level(dim_mapper[dim]);
-        CollectivePhase phase = generate_collective_phase(
-            ComType::Reduce_Scatter,
-            topology->get_basic_topology_at_dimension(
-                dim_mapper[dim], ComType::Reduce_Scatter),
-            tmp,
-            queue.first,
-            queue.second,
-            InjectionPolicy::Normal,
-            implementation_per_dimension[dim_mapper[dim]]);
-        vect.push_back(phase);
-        tmp = phase.final_data_size;
+        StreamBaseline* newStream =
+          new StreamBaseline(this, dataset, stream_id, std::move(vect), pri);
+        newStream->current_queue_id = -1;
+        insert_into_ready_list(newStream);
+      } else {
+        dataset->active = false;
+        break;
+      }
+    }
+    if (!dataset->active) {
+      break;
+    }
+  }
+  if (dataset->active) {
+    dataset->total_streams = count;
+  }
+  return dataset;
+}
+
+vector<CollectivePhase> Sys::generate_collective_phases(
+    LogicalTopology* topology,
+    const vector<CollectiveImpl*>& implementation_per_dimension,
+    const vector<bool>& dimensions_involved,
+    const vector<int>& dim_mapper,
+    ComType collective_type,
+    uint64_t data_size,
+    int channel,
+    int root) {
+  if (is_rooted_collective(collective_type)) {
+    return generate_rooted_collective_phases(
+        topology,
+        implementation_per_dimension,
+        dimensions_involved,
+        collective_type,
+        data_size,
+        channel,
+        root);
+  }
+  uint64_t tmp = data_size;
+  vector<CollectivePhase> vect;
+  vect.reserve(2 * topology->get_num_of_dimensions());
+
+  if (collective_type != ComType::All_Reduce ||
+      collectiveOptimization == CollectiveOptimization::Baseline) {
+    for (int dim = 0; dim < topology->get_num_of_dimensions(); dim++) {
+      if (topology->get_num_of_nodes_in_dimension(dim_mapper[dim]) == 1 ||
+          !dimensions_involved[dim_mapper[dim]]) {
+        continue;
+      }
+      pair<int, RingTopology::Direction> queue =
+          get_next_queue_at_level(dim_mapper[dim], channel);
+      CollectivePhase phase = generate_configured_phase(
+          collective_type,
+          topology,
+          dim_mapper[dim],
+          tmp,
+          queue,
+          implementation_per_dimension[dim_mapper[dim]]);
+      vect.push_back(phase);
+      tmp = phase.final_data_size;
+    }
+  } else if (
+      inter_dimension_scheduling == InterDimensionScheduling::OfflineGreedy ||
+      inter_dimension_scheduling == InterDimensionScheduling::OfflineGreedyFlex ||
+      inter_dimension_scheduling == InterDimensionScheduling::OnlineGreedy) {
+    int dim = 0;
+    for (dim = 0; dim < topology->get_num_of_dimensions(); dim++) {
+      if (topology->get_num_of_nodes_in_dimension(dim_mapper[dim]) == 1 ||
+          !dimensions_involved[dim_mapper[dim]]) {
+        continue;
+      }
+      pair<int, RingTopology::Direction> queue =
+          get_next_queue_at_level(dim_mapper[dim], channel);
+      CollectivePhase phase = generate_configured_phase(
+          ComType::Reduce_Scatter,
+          topology,
+          dim_mapper[dim],
+          tmp,
+          queue,
+          implementation_per_dimension[dim_mapper[dim]]);
+      vect.push_back(phase);
+      tmp = phase.final_data_size;
+    }
+    dim--;
+    for (; dim >= 0; dim--) {
+      if (topology->get_num_of_nodes_in_dimension(dim_mapper[dim]) == 1 ||
+          !dimensions_involved[dim_mapper[dim]]) {
+        continue;
+      }
+      pair<int, RingTopology::Direction> queue =
+          get_next_queue_at_level(dim_mapper[dim], channel);
+      CollectivePhase phase = generate_configured_phase(
+          ComType::All_Gather,
+          topology,
+          dim_mapper[dim],
+          tmp,
+          queue,
+          implementation_per_dimension[dim_mapper[dim]]);
+      vect.push_back(phase);
+      tmp = phase.final_data_size;
+    }
+  } else {
+    int dim = 0;
+    int last_active_dim = 0;
+    for (dim = 0; dim < topology->get_num_of_dimensions(); dim++) {
+      if (topology->get_num_of_nodes_in_dimension(dim_mapper[dim]) != 1 &&
+          dimensions_involved[dim_mapper[dim]]) {
+        last_active_dim = dim;
+      }
+    }
+    for (dim = 0; dim < last_active_dim; dim++) {
+      if (topology->get_num_of_nodes_in_dimension(dim_mapper[dim]) == 1 ||
+          !dimensions_involved[dim_mapper[dim]]) {
+        continue;
       }
+      pair<int, RingTopology::Direction> queue =
+          get_next_queue_at_level(dim_mapper[dim], channel);
+      CollectivePhase phase = generate_configured_phase(
+          ComType::Reduce_Scatter,
+          topology,
+          dim_mapper[dim],
+          tmp,
+          queue,
+          implementation_per_dimension[dim_mapper[dim]]);
+      vect.push_back(phase);
+      tmp = phase.final_data_size;
+    }
+    while (dim > 0 &&
+           (dimensions_involved[dim_mapper[dim]] == false ||
+            topology->get_num_of_nodes_in_dimension(dim_mapper[dim]) == 1)) {
       dim--;
-      for (; dim >= 0; dim--) {
-        if (topology->get_num_of_nodes_in_dimension(dim_mapper[dim]) == 1 ||
-            !dimensions_involved[dim_mapper[dim]]) {
-          continue;
-        }
-        pair<int, RingTopology::Direction> queue =
-            vLevels->get_next_queue_at_level(dim_mapper[dim]);
-        CollectivePhase phase = generate_collective_phase(
-            ComType::All_Gather,
-            topology->get_basic_topology_at_dimension(
-                dim_mapper[dim], ComType::All_Gather),
-            tmp,
-            queue.first,
-            queue.second,
-            InjectionPolicy::Normal,
-            implementation_per_dimension[dim_mapper[dim]]);
-        vect.push_back(phase);
-        tmp = phase.final_data_size;
+    }
+    if (dimensions_involved[dim_mapper[dim]] &&
+        topology->get_num_of_nodes_in_dimension(dim_mapper[dim]) > 1) {
+      pair<int, RingTopology::Direction> queue =
+          get_next_queue_at_level(dim_mapper[dim], channel);
+      CollectivePhase phase = generate_configured_phase(
+          ComType::All_Reduce,
+          topology,
+          dim_mapper[dim],
+          tmp,
+          queue,
+          implementation_per_dimension[dim_mapper[dim]]);
+      vect.push_back(phase);
+      tmp = phase.final_data_size;
+    }
+    dim--;
+    for (; dim >= 0; dim--) {
+      if (topology->get_num_of_nodes_in_dimension(dim_mapper[dim]) == 1 ||
+          !dimensions_involved[dim_mapper[dim]]) {
+        continue;
+      }
+      pair<int, RingTopology::Direction> queue =
+          get_next_queue_at_level(dim_mapper[dim], channel);
+      CollectivePhase phase = generate_configured_phase(
+          ComType::All_Gather,
+          topology,
+          dim_mapper[dim],
+          tmp,
+          queue,
+          implementation_per_dimension[dim_mapper[dim]]);
+      vect.push_back(phase);
+      tmp = phase.final_data_size;
+    }
+  }
+  return vect;
+}
+
+vector<CollectivePhase> Sys::generate_rooted_collective_phases(
+    LogicalTopology* topology,
+    const vector<CollectiveImpl*>& implementation_per_dimension,
+    const vector<bool>& dimensions_involved,
+    ComType collective_type,
+    uint64_t data_size,
+    int channel,
+    int root) {
+  // The root is projected on every dimension. A dimension is run by the NPUs
+  // that share the root's index on all the lower involved dimensions, so
+  // reduce/gather move towards the root from the lowest dimension up, and
+  // broadcast/scatter move away from it from the highest dimension down.
+  int dims = topology->get_num_of_dimensions();
+  vector<RingTopology*> rings(dims);
+  vector<int> root_index(dims, 0);
+  vector<bool> participates(dims, false);
+  bool on_root_path = true;
+  int stride = 1;
+  for (int dim = 0; dim < dims; dim++) {
+    BasicLogicalTopology* basic_topology =
+        topology->get_basic_topology_at_dimension(dim, collective_type);
+    if (basic_topology->basic_topology !=
+        BasicLogicalTopology::BasicTopology::Ring) {
+      sys_panic("rooted collectives need ring-based logical dimensions");
+    }
+    rings[dim] = (RingTopology*)basic_topology;
+    int nodes = rings[dim]->get_nodes_in_ring();
+    if (dims == 1) {
+      root_index[dim] = rings[dim]->get_index_of(root);
+      if (root_index[dim] == -1) {
+        sys_panic(
+            "the root " + to_string(root) + " of a rooted collective is not in the group of NPU " +
+            to_string(id));
       }
     } else {
-      int dim = 0;
-      int last_active_dim = 0;
-      for (dim = 0; dim < topology->get_num_of_dimensions(); dim++) {
-        if (topology->get_num_of_nodes_in_dimension(dim_mapper[dim]) != 1 &&
-            dimensions_involved[dim_mapper[dim]]) {
-          last_active_dim = dim;
-        }
+      root_index[dim] = (root / stride) % nodes;
+    }
+    stride *= nodes;
+    if (nodes == 1 || !dimensions_involved[dim]) {
+      continue;
+    }
+    participates[dim] = on_root_path;
+    if (rings[dim]->get_index_in_ring() != root_index[dim]) {
+      on_root_path = false;
+    }
+  }
+
+  uint64_t tmp = data_size;
+  vector<CollectivePhase> vect;
+  vect.reserve(2 * topology->get_num_of_dimensions());
+  if (collective_type == ComType::Reduce ||
+      collective_type == ComType::Gather ||
+      collective_type == ComType::Barrier) {
+    ComType type = collective_type == ComType::Barrier ? ComType::Reduce
+                                                       : collective_type;
+    for (int dim = 0; dim < dims; dim++) {
+      if (rings[dim]->get_nodes_in_ring() == 1 || !dimensions_involved[dim]) {
+        continue;
       }
-      for (dim = 0; dim < last_active_dim; dim++) {
-        if (topology->get_num_of_nodes_in_dimension(dim_mapper[dim]) == 1 ||
-            !dimensions_involved[dim_mapper[dim]]) {
-          continue;
-        }
-        pair<int, RingTopology::Direction> queue =
-            vLevels->get_next_queue_at_level(dim_mapper[dim]);
-        CollectivePhase phase = generate_collective_phase(
-            ComType::Reduce_Scatter,
-            topology->get_basic_topology_at_dimension(
-                dim_mapper[dim], ComType::Reduce_Scatter),
+      // every NPU takes a queue so the queue allocation stays aligned across
+      // NPUs, even on the dimensions it is not part of
+      pair<int, RingTopology::Direction> queue =
+          get_next_queue_at_level(dim, channel);
+      if (participates[dim]) {
+        vect.push_back(generate_rooted_collective_phase(
+            type,
+            rings[dim],
             tmp,
             queue.first,
-            queue.second,
-            InjectionPolicy::Normal,
-            implementation_per_dimension[dim_mapper[dim]]);
-        vect.push_back(phase);
-        tmp = phase.final_data_size;
+            root_index[dim],
+            implementation_per_dimension[dim]));
       }
-      while (dim > 0 &&
-             (dimensions_involved[dim_mapper[dim]] == false ||
-              topology->get_num_of_nodes_in_dimension(dim_mapper[dim]) == 1)) {
-        dim--;
+      if (type == ComType::Gather) {
+        tmp *= rings[dim]->get_nodes_in_ring();
       }
-      if (dimensions_involved[dim_mapper[dim]] &&
-          topology->get_num_of_nodes_in_dimension(dim_mapper[dim]) > 1) {
-        pair<int, RingTopology::Direction> queue =
-            vLevels->get_next_queue_at_level(dim_mapper[dim]);
-        CollectivePhase phase = generate_collective_phase(
-            ComType::All_Reduce,
-            topology->get_basic_topology_at_dimension(
-                dim_mapper[dim], ComType::All_Reduce),
-            tmp,
-            queue.first,
-            queue.second,
-            InjectionPolicy::Normal,
-            implementation_per_dimension[dim_mapper[dim]]);
-        vect.push_back(phase);
-        tmp = phase.final_data_size;
+    }
+  }
+  if (collective_type == ComType::Broadcast ||
+      collective_type == ComType::Scatter ||
+      collective_type == ComType::Barrier) {
+    ComType type = collective_type == ComType::Barrier ? ComType::Broadcast
+                                                       : collective_type;
+    for (int dim = dims - 1; dim >= 0; dim--) {
+      if (rings[dim]->get_nodes_in_ring() == 1 || !dimensions_involved[dim]) {
+        continue;
       }
-      dim--;
-      for (; dim >= 0; dim--) {
-        if (topology->get_num_of_nodes_in_dimension(dim_mapper[dim]) == 1 ||
-            !dimensions_involved[dim_mapper[dim]]) {
-          continue;
-        }
-        pair<int, RingTopology::Direction> queue =
-            vLevels->get_next_queue_at_level(dim_mapper[dim]);
-        CollectivePhase phase = generate_collective_phase(
-            ComType::All_Gather,
-            topology->get_basic_topology_at_dimension(
-                dim_mapper[dim], ComType::All_Gather),
+      pair<int, RingTopology::Direction> queue =
+          get_next_queue_at_level(dim, channel);
+      if (participates[dim]) {
+        vect.push_back(generate_rooted_collective_phase(
+            type,
+            rings[dim],
             tmp,
             queue.first,
-            queue.second,
-            InjectionPolicy::Normal,
-            implementation_per_dimension[dim_mapper[dim]]);
-        vect.push_back(phase);
-        tmp = phase.final_data_size;
+            root_index[dim],
+            implementation_per_dimension[dim]));
+      }
+      if (type == ComType::Scatter) {
+        tmp /= rings[dim]->get_nodes_in_ring();
       }
     }
-    if (vect.size() > 0) {
-      int stream_id = num_streams++;
-      if (communicator_group != nullptr) {
-        stream_id = communicator_group->num_streams++;
+  }
+  return vect;
+}
+
+bool Sys::is_rooted_collective(ComType collective_type) {
+  return collective_type == ComType::Broadcast ||
+      collective_type == ComType::Reduce ||
+      collective_type == ComType::Gather ||
+      collective_type == ComType::Scatter ||
+      collective_type == ComType::Barrier;
+}
+
+void Sys::configure_phase(CollectivePhase& phase, int dim) {
+  dim = get_physical_dimension(dim);
+  // the routes set the number of messages the segments are cut from
+  if (dim < packet_routing_per_dimension.size() &&
+      packet_routing_per_dimension[dim] == PacketRouting::Software) {
+    phase.algorithm->enable_software_routing();
+  }
+  if (dim < compression_per_dimension.size() &&
+      compression_per_dimension[dim].is_enabled()) {
+    phase.algorithm->enable_compression(compression_per_dimension[dim]);
+  }
+  // segments are cut from the (compressed) messages on the wire
+  if (segment_size > 0) {
+    phase.algorithm->enable_segmentation(segment_size);
+  }
+}
+
+// Repeated collectives (every training iteration issues the same ones) build
+// the same phases over and over. The first phase built for a given type,
+// dimension, size, direction and implementation is kept as a template, and
+// later ones are copied from it instead of going through the tuner, the
+// algorithm constructor and configure_phase again. Only the queue differs
+// between instances, and it lives in the CollectivePhase.
+CollectivePhase Sys::generate_configured_phase(
+    ComType collective_type,
+    LogicalTopology* topology,
+    int dim,
+    uint64_t data_size,
+    pair<int, RingTopology::Direction> queue,
+    CollectiveImpl* collective_impl) {
+  PhaseTemplateKey key = make_tuple(
+      collective_type,
+      topology,
+      dim,
+      data_size,
+      queue.second,
+      collective_impl);
+  if (phase_template_cache) {
+    auto it = phase_templates.find(key);
+    if (it != phase_templates.end()) {
+      phase_template_order.splice(
+          phase_template_order.begin(), phase_template_order, it->second.second);
+      return CollectivePhase(this, queue.first, it->second.first->clone());
+    }
+  }
+  CollectivePhase phase = generate_collective_phase(
+      collective_type,
+      topology->get_basic_topology_at_dimension(dim, collective_type),
+      data_size,
+      queue.first,
+      queue.second,
+      get_injection_policy(dim),
+      get_tuned_implementation(
+          collective_type,
+          dim,
+          topology->get_num_of_nodes_in_dimension(dim),
+          data_size,
+          collective_impl));
+  configure_phase(phase, dim);
+  // all-to-allv message sizes are redrawn for every collective
+  if (phase_template_cache && collective_type != ComType::All_to_Allv) {
+    Algorithm* phase_template = phase.algorithm->clone();
+    if (phase_template != nullptr) {
+      phase_template_order.push_front(key);
+      phase_templates[key] =
+          make_pair(phase_template, phase_template_order.begin());
+      if (phase_templates.size() > max_phase_templates) {
+        auto oldest = phase_templates.find(phase_template_order.back());
+        delete oldest->second.first;
+        phase_templates.erase(oldest);
+        phase_template_order.pop_back();
       }
-      StreamBaseline* newStream =
-        new StreamBaseline(this, dataset, stream_id, vect, pri);
-      newStream->current_queue_id = -1;
-      insert_into_ready_list(newStream);
-    } else {
-      dataset->active = false;
-      break;
     }
   }
-  if (dataset->active) {
-    dataset->total_streams = count;
+  return phase;
+}
+
+void Sys::clear_phase_templates() {
+  for (auto& phase_template : phase_templates) {
+    delete phase_template.second.first;
+  }
+  phase_templates.clear();
+  phase_template_order.clear();
+}
+
+InjectionPolicy Sys::get_injection_policy(int dim) {
+  dim = get_physical_dimension(dim);
+  if (dim < injection_policy_per_dimension.size()) {
+    return injection_policy_per_dimension[dim];
+  }
+  return InjectionPolicy::Normal;
+}
+
+CollectiveImpl* Sys::get_tuned_implementation(
+    ComType collective_type,
+    int dim,
+    int nodes,
+    uint64_t data_size,
+    CollectiveImpl* collective_impl) {
+  if (autotuner == nullptr) {
+    return collective_impl;
+  }
+  return autotuner->get_implementation(
+      collective_type,
+      get_physical_dimension(dim),
+      nodes,
+      data_size,
+      collective_impl);
+}
+
+pair<int, RingTopology::Direction> Sys::get_next_queue_at_level(
+    int level,
+    int channel) {
+  if (channel < 0) {
+    return vLevels->get_next_queue_at_level(level);
+  }
+  // streams pinned to a channel only use one half of the queues of each
+  // dimension: even channels run clockwise and odd channels anticlockwise
+  if (channel % 2 == 0) {
+    return vLevels->get_next_queue_at_level_first(level);
+  } else {
+    return vLevels->get_next_queue_at_level_last(level);
   }
-  return dataset;
 }
 
 CollectivePhase Sys::generate_collective_phase(
@@ -996,9 +1884,26 @@ CollectivePhase Sys::generate_collective_phase(
     RingTopology::Direction direction,
     InjectionPolicy injection_policy,
     CollectiveImpl* collective_impl) {
+  if (collective_type == ComType::All_to_Allv &&
+      collective_impl->type != CollectiveImplType::Direct &&
+      collective_impl->type != CollectiveImplType::OneDirect &&
+      collective_impl->type != CollectiveImplType::HierarchicalDirect) {
+    sys_panic("all-to-allv is only supported by the direct all-to-all implementations");
+  }
+  // the tree dimensions of the composite topologies are rings for the
+  // collectives other than all-reduce
+  if (collective_impl->type == CollectiveImplType::DoubleBinaryTree &&
+      topology->basic_topology != BasicLogicalTopology::BasicTopology::BinaryTree) {
+    static CollectiveImpl ring_implementation(CollectiveImplType::Ring);
+    collective_impl = &ring_implementation;
+  }
   if (collective_impl->type == CollectiveImplType::Ring ||
       collective_impl->type ==
-          CollectiveImplType::OneRing) {
+          CollectiveImplType::OneRing ||
+      collective_impl->type ==
+          CollectiveImplType::OneRingSnake ||
+      collective_impl->type ==
+          CollectiveImplType::MultiChannelRing) {
     CollectivePhase vn(
         this,
         queue_id,
@@ -1013,7 +1918,9 @@ CollectivePhase Sys::generate_collective_phase(
   } else if (
       collective_impl->type == CollectiveImplType::Direct ||
       collective_impl->type ==
-          CollectiveImplType::OneDirect) {
+          CollectiveImplType::OneDirect ||
+      collective_impl->type ==
+          CollectiveImplType::HierarchicalDirect) {
     CollectivePhase vn(
         this,
         queue_id,
@@ -1025,7 +1932,9 @@ CollectivePhase Sys::generate_collective_phase(
             (RingTopology*)topology,
             data_size,
             direction,
-            InjectionPolicy::Normal));
+            injection_policy,
+            all_to_allv_skew,
+            all_to_allv_sequence));
     return vn;
   } else if (
       collective_impl->type ==
@@ -1050,6 +1959,24 @@ CollectivePhase Sys::generate_collective_phase(
             (RingTopology*)topology,
             data_size));
     return vn;
+  } else if (
+      collective_impl->type == CollectiveImplType::InNetwork) {
+    // the switch reduces the data at in-network-reduction-throughput (GB/s)
+    Tick reduction_delay = 0;
+    if (in_network_reduction_throughput > 0) {
+      reduction_delay =
+          (data_size / in_network_reduction_throughput) / CLOCK_PERIOD;
+    }
+    CollectivePhase vn(
+        this,
+        queue_id,
+        new InNetwork(
+            collective_type,
+            id,
+            (RingTopology*)topology,
+            data_size,
+            reduction_delay));
+    return vn;
   } else {
     cerr
         << "Error: No known collective implementation for collective phase"
@@ -1058,119 +1985,121 @@ CollectivePhase Sys::generate_collective_phase(
   }
 }
 
+CollectivePhase Sys::generate_rooted_collective_phase(
+    ComType collective_type,
+    RingTopology* topology,
+    uint64_t data_size,
+    int queue_id,
+    int root_index,
+    CollectiveImpl* collective_impl) {
+  if (collective_impl->type == CollectiveImplType::Chain) {
+    CollectivePhase vn(
+        this,
+        queue_id,
+        new Chain(collective_type, id, topology, data_size, root_index));
+    return vn;
+  } else {
+    CollectivePhase vn(
+        this,
+        queue_id,
+        new BinomialTree(collective_type, id, topology, data_size, root_index));
+    return vn;
+  }
+}
+
+// Cuts the logical dimensions once more so that a model parallel group of
+// the given size covers whole logical dimensions (on top of the
+// factorization of parallel-group-sizes). Returns the physical dimension
+// where the group ends, or -1 if it spans a single NPU or the whole network.
 int Sys::break_dimension(int model_parallel_npu_group) {
   if (break_dimension_done) {
     return dimension_to_break;
   }
-
-  dimension_to_break = 0;
+  break_dimension_done = true;
+  dimension_to_break = -1;
   if (model_parallel_npu_group == 1) {
-    break_dimension_done = true;
     return -1;
   }
-  int all_npus = 1;
-  for (; dimension_to_break < physical_dims.size(); dimension_to_break++) {
-    if (all_npus * physical_dims[dimension_to_break] <
-        model_parallel_npu_group) {
-      all_npus *= physical_dims[dimension_to_break];
-    } else if (
-        all_npus * physical_dims[dimension_to_break] >
-        model_parallel_npu_group) {
-      for (auto lt : logical_topologies) {
-        delete lt.second;
-      }
-      logical_topologies.clear();
-
-      delete scheduler_unit;
-      delete vLevels;
-      std::vector<int>::iterator levelIterator = queues_per_dim.begin();
-      std::advance(levelIterator, dimension_to_break);
-      queues_per_dim.insert(levelIterator, queues_per_dim[dimension_to_break]);
-      scheduler_unit = new SchedulerUnit(
-          this,
-          queues_per_dim,
-          max_running,
-          active_first_phase,
-          concurrent_streams);
-      vLevels = new QueueLevels(queues_per_dim, 0, comm_NI->get_backend_type());
-
-      int first_subdim = model_parallel_npu_group / all_npus;
-      int second_subdim = physical_dims[dimension_to_break] / first_subdim;
-      std::vector<int> logical_dims;
-
-      for (int dim = 0; dim < physical_dims.size(); dim++) {
-        if (dim != dimension_to_break) {
-          logical_dims.push_back(physical_dims[dim]);
-        } else {
-          logical_dims.push_back(first_subdim);
-          logical_dims.push_back(second_subdim);
-        }
-      }
-
-      std::vector<CollectiveImpl*>::iterator it =
-          all_reduce_implementation_per_dimension.begin();
-      if (all_reduce_implementation_per_dimension.size() > dimension_to_break) {
-        std::advance(it, dimension_to_break);
-      } else {
-        std::advance(it, all_reduce_implementation_per_dimension.size());
-      }
-      CollectiveImpl* replicate =
-          (CollectiveImpl*)(*it)->clone();
-      all_reduce_implementation_per_dimension.insert(it, replicate);
-
-      it = reduce_scatter_implementation_per_dimension.begin();
-      if (reduce_scatter_implementation_per_dimension.size() >
-          dimension_to_break) {
-        std::advance(it, dimension_to_break);
-      } else {
-        std::advance(it, reduce_scatter_implementation_per_dimension.size());
-      }
-      replicate = (CollectiveImpl*)(*it)->clone();
-      reduce_scatter_implementation_per_dimension.insert(it, replicate);
+  // every boundary of parallel-group-sizes is kept, with the one of the
+  // model parallel group merged in order
+  vector<int> group_sizes;
+  int group_size = 1;
+  for (int size : system_config->parallel_group_sizes) {
+    group_size *= size;
+    group_sizes.push_back(group_size);
+  }
+  group_sizes.push_back(model_parallel_npu_group);
+  sort(group_sizes.begin(), group_sizes.end());
+  group_sizes.erase(
+      unique(group_sizes.begin(), group_sizes.end()), group_sizes.end());
+  DimensionFactorization factorization;
+  string error;
+  if (!SystemConfig::factorize_dimensions(
+          physical_dims, group_sizes, factorization, error)) {
+    sys_panic(error);
+  }
+  int npus = 1;
+  for (int dim = 0; dim < factorization.logical_dims.size(); dim++) {
+    npus *= factorization.logical_dims[dim];
+    if (npus == model_parallel_npu_group) {
+      dimension_to_break = factorization.physical_dim[dim];
+      break;
+    }
+  }
+  if (factorization.logical_dims == logical_dims) {
+    return dimension_to_break;
+  }
 
-      it = all_gather_implementation_per_dimension.begin();
-      if (all_gather_implementation_per_dimension.size() > dimension_to_break) {
-        std::advance(it, dimension_to_break);
-      } else {
-        std::advance(it, all_gather_implementation_per_dimension.size());
-      }
-      replicate = (CollectiveImpl*)(*it)->clone();
-      all_gather_implementation_per_dimension.insert(it, replicate);
+  for (auto lt : logical_topologies) {
+    delete lt.second;
+  }
+  logical_topologies.clear();
+  clear_phase_templates();
+  delete scheduler_unit;
+  delete vLevels;
+
+  all_reduce_implementation_per_dimension =
+      system_config->all_reduce_implementation_per_dimension;
+  reduce_scatter_implementation_per_dimension =
+      system_config->reduce_scatter_implementation_per_dimension;
+  all_gather_implementation_per_dimension =
+      system_config->all_gather_implementation_per_dimension;
+  all_to_all_implementation_per_dimension =
+      system_config->all_to_all_implementation_per_dimension;
+  if (system_config->rooted_implementation_per_dimension.size() > 0) {
+    rooted_implementation_per_dimension =
+        system_config->rooted_implementation_per_dimension;
+  } else {
+    rooted_implementation_per_dimension.assign(
+        physical_dims.size(), system_config->default_rooted_implementation);
+  }
+  apply_dimension_factorization(factorization);
 
-      it = all_to_all_implementation_per_dimension.begin();
-      if (all_to_all_implementation_per_dimension.size() > dimension_to_break) {
-        std::advance(it, dimension_to_break);
-      } else {
-        std::advance(it, all_to_all_implementation_per_dimension.size());
+  int element = 0;
+  for (int queues : queues_per_dim) {
+    for (int j = 0; j < queues; j++) {
+      if (active_Streams.find(element) == active_Streams.end()) {
+        active_Streams[element] = list<BaseStream*>();
+        stream_priorities[element] = list<int>();
       }
-      replicate = (CollectiveImpl*)(*it)->clone();
-      all_to_all_implementation_per_dimension.insert(it, replicate);
-      logical_topologies["AllReduce"] = new GeneralComplexTopology(
-          id, logical_dims, all_reduce_implementation_per_dimension);
-      logical_topologies["ReduceScatter"] = new GeneralComplexTopology(
-          id, logical_dims, reduce_scatter_implementation_per_dimension);
-      logical_topologies["AllGather"] = new GeneralComplexTopology(
-          id, logical_dims, all_gather_implementation_per_dimension);
-      logical_topologies["AllToAll"] = new GeneralComplexTopology(
-          id, logical_dims, all_to_all_implementation_per_dimension);
-      this->logical_broken_dims = logical_dims;
-      this->dim_to_break = dimension_to_break;
-
-      break_dimension_done = true;
-      return dimension_to_break;
-    } else if (
-        all_npus * physical_dims[dimension_to_break] ==
-        model_parallel_npu_group) {
-      break_dimension_done = true;
-      return dimension_to_break;
+      element++;
     }
   }
-
-  break_dimension_done = true;
-  return -1;
+  scheduler_unit = new SchedulerUnit(
+      this,
+      queues_per_dim,
+      max_running,
+      active_first_phase,
+      concurrent_streams);
+  vLevels = new QueueLevels(queues_per_dim, 0, comm_NI->get_backend_type());
+  generate_logical_topologies();
+  return dimension_to_break;
 }
 
 uint64_t Sys::determine_chunk_size(uint64_t size, ComType type) {
+  if (type == ComType::Barrier) {
+    return size;
+  }
   uint64_t chunk_size = size / preferred_dataset_splits;
   return chunk_size;
 }
@@ -1197,6 +2126,7 @@ void Sys::insert_stream(list<BaseStream*>* queue, BaseStream* baseStream) {
   if (intra_dimension_scheduling == IntraDimensionScheduling::FIFO ||
       baseStream->current_queue_id < 0 ||
       baseStream->current_com_type == ComType::All_to_All ||
+      baseStream->current_com_type == ComType::All_to_Allv ||
       baseStream->current_com_type == ComType::All_Reduce) {
     while (it != queue->end()) {
       if ((*it)->initialized == true) {
@@ -1371,7 +2301,7 @@ void Sys::proceed_to_next_vnet_baseline(StreamBaseline* stream) {
 
   CollectivePhase vi = stream->phases_to_go.front();
   stream->my_current_phase = vi;
-  stream->phases_to_go.pop_front();
+  stream->phases_to_go.erase(stream->phases_to_go.begin());
   stream->test = 0;
   stream->test2 = 0;
   stream->initialized = false;
@@ -7,6 +7,9 @@ LICENSE file in the root directory of this source tree.
 #define __SYSTEM_HH__
 
 #include <chrono>
+#include <list>
+#include <map>
+#include <tuple>
 
 #include "astra-sim/workload/Workload.hh"
 #include "astra-sim/system/AstraMemoryAPI.hh"
@@ -29,6 +32,10 @@ class Workload;
 class LogicalTopology;
 class BasicLogicalTopology;
 class OfflineGreedy;
+class CollectiveAutotuner;
+class PlacementOptimizer;
+class SystemConfig;
+class DimensionFactorization;
 
 class Sys : public Callable {
  public:
@@ -77,7 +84,13 @@ class Sys : public Callable {
 
   // Intialization ------------------------------------------------------------
   bool initialize_sys(std::string name);
-  CollectiveImpl* generate_collective_impl_from_input(std::string collective_impl_str);
+  static CollectiveImpl* generate_collective_impl_from_input(
+      std::string collective_impl_str);
+  static int get_implementation_parameter(
+      std::string collective_impl_str,
+      int name_length);
+  InjectionPolicy generate_injection_policy_from_input(
+      std::string injection_policy_str);
   //---------------------------------------------------------------------------
 
   // Helper Functions ---------------------------------------------------------
@@ -112,38 +125,142 @@ class Sys : public Callable {
 
   // Communicator Group Support -----------------------------------------------
   LogicalTopology* get_logical_topology(ComType comm_type);
+  void generate_logical_topologies();
+  void apply_dimension_factorization(
+      const DimensionFactorization& factorization);
+  std::vector<CollectiveImpl*> get_logical_implementation(
+      const std::vector<CollectiveImpl*>& implementation_per_physical_dimension);
+  int get_physical_dimension(int dim);
+  LogicalTopology* generate_logical_topology(
+      std::string name,
+      const std::vector<CollectiveImpl*>& implementation_per_dimension);
   std::vector<CollectiveImpl*> get_collective_implementation(ComType comm_type);
   //---------------------------------------------------------------------------
 
   // Collective Communication Primitives --------------------------------------
   DataSet* generate_all_reduce(
       uint64_t size,
-      std::vector<bool> involved_dimensions,
+      const std::vector<bool>& involved_dimensions,
       CommunicatorGroup *communicator_group,
       int explicit_priority);
   DataSet* generate_all_to_all(
       uint64_t size,
-      std::vector<bool> involved_dimensions,
+      const std::vector<bool>& involved_dimensions,
+      CommunicatorGroup *communicator_group,
+      int explicit_priority);
+  DataSet* generate_all_to_allv(
+      uint64_t size,
+      const std::vector<bool>& involved_dimensions,
       CommunicatorGroup *communicator_group,
       int explicit_priority);
   DataSet* generate_all_gather(
       uint64_t size,
-      std::vector<bool> involved_dimensions,
+      const std::vector<bool>& involved_dimensions,
       CommunicatorGroup *communicator_group,
       int explicit_priority);
   DataSet* generate_reduce_scatter(
       uint64_t size,
-      std::vector<bool> involved_dimensions,
+      const std::vector<bool>& involved_dimensions,
+      CommunicatorGroup *communicator_group,
+      int explicit_priority);
+  DataSet* generate_all_reduce_all_to_all(
+      uint64_t all_reduce_size,
+      uint64_t all_to_all_size,
+      const std::vector<bool>& all_reduce_involved_dimensions,
+      const std::vector<bool>& all_to_all_involved_dimensions,
+      CommunicatorGroup *communicator_group,
+      int explicit_priority);
+  double estimate_isolated_time(
+      LogicalTopology* topology,
+      const std::vector<bool>& dimensions_involved,
+      ComType collective_type,
+      uint64_t size);
+  static double estimate_hierarchical_time(
+      const std::vector<std::pair<int, double>>& dimensions,
+      ComType collective_type,
+      double size);
+  DataSet* generate_broadcast(
+      uint64_t size,
+      int root,
+      const std::vector<bool>& involved_dimensions,
+      CommunicatorGroup *communicator_group,
+      int explicit_priority);
+  DataSet* generate_reduce(
+      uint64_t size,
+      int root,
+      const std::vector<bool>& involved_dimensions,
+      CommunicatorGroup *communicator_group,
+      int explicit_priority);
+  DataSet* generate_gather(
+      uint64_t size,
+      int root,
+      const std::vector<bool>& involved_dimensions,
+      CommunicatorGroup *communicator_group,
+      int explicit_priority);
+  DataSet* generate_scatter(
+      uint64_t size,
+      int root,
+      const std::vector<bool>& involved_dimensions,
+      CommunicatorGroup *communicator_group,
+      int explicit_priority);
+  DataSet* generate_barrier(
+      const std::vector<bool>& involved_dimensions,
+      CommunicatorGroup *communicator_group,
+      int explicit_priority);
+  DataSet* generate_rooted_collective(
+      uint64_t size,
+      int root,
+      const std::vector<bool>& involved_dimensions,
+      ComType collective_type,
       CommunicatorGroup *communicator_group,
       int explicit_priority);
   DataSet* generate_collective(
       uint64_t size,
       LogicalTopology* topology,
-      std::vector<CollectiveImpl*> implementation_per_dimension,
-      std::vector<bool> dimensions_involved,
+      const std::vector<CollectiveImpl*>& implementation_per_dimension,
+      const std::vector<bool>& dimensions_involved,
       ComType collective_type,
       int explicit_priority,
-      CommunicatorGroup *communicator_group);
+      CommunicatorGroup *communicator_group,
+      int queue_channel = -1,
+      int root = 0);
+  std::vector<CollectivePhase> generate_collective_phases(
+      LogicalTopology* topology,
+      const std::vector<CollectiveImpl*>& implementation_per_dimension,
+      const std::vector<bool>& dimensions_involved,
+      const std::vector<int>& dim_mapper,
+      ComType collective_type,
+      uint64_t data_size,
+      int channel,
+      int root);
+  std::vector<CollectivePhase> generate_rooted_collective_phases(
+      LogicalTopology* topology,
+      const std::vector<CollectiveImpl*>& implementation_per_dimension,
+      const std::vector<bool>& dimensions_involved,
+      ComType collective_type,
+      uint64_t data_size,
+      int channel,
+      int root);
+  bool is_rooted_collective(ComType collective_type);
+  void configure_phase(CollectivePhase& phase, int dim);
+  CollectivePhase generate_configured_phase(
+      ComType collective_type,
+      LogicalTopology* topology,
+      int dim,
+      uint64_t data_size,
+      std::pair<int, RingTopology::Direction> queue,
+      CollectiveImpl* collective_impl);
+  void clear_phase_templates();
+  InjectionPolicy get_injection_policy(int dim);
+  CollectiveImpl* get_tuned_implementation(
+      ComType collective_type,
+      int dim,
+      int nodes,
+      uint64_t data_size,
+      CollectiveImpl* collective_impl);
+  std::pair<int, RingTopology::Direction> get_next_queue_at_level(
+      int level,
+      int channel);
   CollectivePhase generate_collective_phase(
       ComType collective_type,
       BasicLogicalTopology* topology,
@@ -152,6 +269,13 @@ class Sys : public Callable {
       RingTopology::Direction direction,
       InjectionPolicy injection_policy,
       CollectiveImpl* collective_impl);
+  CollectivePhase generate_rooted_collective_phase(
+      ComType collective_type,
+      RingTopology* topology,
+      uint64_t data_size,
+      int queue_id,
+      int root_index,
+      CollectiveImpl* collective_impl);
   int break_dimension(int model_parallel_npu_group);
   //---------------------------------------------------------------------------
 
@@ -270,12 +394,20 @@ class Sys : public Callable {
   SchedulerUnit* scheduler_unit;
   QueueLevels* vLevels;
   OfflineGreedy* offline_greedy;
+  CollectiveAutotuner* autotuner;
+  PlacementOptimizer* placement_optimizer;
+  std::string placement_search_output;
+  std::string logical_topology_file;
   IntraDimensionScheduling intra_dimension_scheduling;
   InterDimensionScheduling inter_dimension_scheduling;
   int round_robin_inter_dimension_scheduler;
   int active_chunks_per_dimension;
   int priority_counter;
   uint64_t pending_events;
+  // totals over the run, to compare the cost of runs with different options
+  uint64_t scheduled_events;
+  uint64_t created_streams;
+  uint64_t created_phases;
   int preferred_dataset_splits;
   int concurrent_streams;
   int active_first_phase;
@@ -291,24 +423,62 @@ class Sys : public Callable {
 
   std::map<Tick, std::list<std::tuple<Callable*, EventType, CallData*> > > event_queue;
   int total_nodes;
-  int dim_to_break;
-  std::vector<int> logical_broken_dims;
 
   std::vector<int> physical_dims;
+  std::vector<int> physical_queues_per_dim;
+  // the dimensions the collectives run on (the physical ones, cut by the
+  // parallel groups), the physical dimension of each of them and their queues
+  std::vector<int> logical_dims;
+  std::vector<int> logical_to_physical_dim;
   std::vector<int> queues_per_dim;
 
   // collective communication
   int num_streams;
   static uint8_t* dummy_data;
   std::map<std::string, LogicalTopology*> logical_topologies;
+  SystemConfig* system_config;
   std::vector<CollectiveImpl*> all_reduce_implementation_per_dimension;
   std::vector<CollectiveImpl*> reduce_scatter_implementation_per_dimension;
   std::vector<CollectiveImpl*> all_gather_implementation_per_dimension;
   std::vector<CollectiveImpl*> all_to_all_implementation_per_dimension;
+  std::vector<CollectiveImpl*> rooted_implementation_per_dimension;
+  static const uint64_t barrier_token_size = 8;
   CollectiveOptimization collectiveOptimization;
   Tick last_scheduled_collective;
   bool break_dimension_done;
   int dimension_to_break;
+  bool fuse_all_reduce_all_to_all;
+  double all_to_allv_skew;
+  // sequence number of the all-to-allv being generated, and the next one of
+  // every communicator group (-1 for all the NPUs)
+  int all_to_allv_sequence;
+  std::map<int, int> all_to_allv_sequence_per_group;
+  double in_network_reduction_throughput;
+  std::vector<PacketRouting> packet_routing_per_dimension;
+  std::vector<CompressionConfig> compression_per_dimension;
+  std::vector<InjectionPolicy> injection_policy_per_dimension;
+  uint64_t segment_size;
+  // configured algorithms the phases of repeated collectives are copied from
+  typedef std::tuple<
+      ComType,
+      LogicalTopology*,
+      int,
+      uint64_t,
+      RingTopology::Direction,
+      CollectiveImpl*>
+      PhaseTemplateKey;
+  bool phase_template_cache;
+  // the templates, with their place in phase_template_order (most recently
+  // used first); the least recently used ones are dropped beyond
+  // max_phase_templates, so the chunk sizes of a long run do not pile up
+  std::map<
+      PhaseTemplateKey,
+      std::pair<Algorithm*, std::list<PhaseTemplateKey>::iterator>>
+      phase_templates;
+  std::list<PhaseTemplateKey> phase_template_order;
+  static const int max_phase_templates = 256;
+  uint64_t comm_fusion_bucket_size;
+  Tick comm_fusion_window;
 
   // statistics
   bool trace_enabled;
@@ -0,0 +1,277 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "astra-sim/system/SystemConfig.hh"
+
+#include <fstream>
+#include <iostream>
+
+#include "astra-sim/system/Sys.hh"
+#include "astra-sim/system/scheduling/CollectiveAutotuner.hh"
+
+using namespace std;
+using namespace AstraSim;
+
+map<string, SystemConfig*> SystemConfig::system_configs;
+
+SystemConfig* SystemConfig::get_system_config(string path) {
+  auto it = system_configs.find(path);
+  if (it != system_configs.end()) {
+    return it->second;
+  }
+  SystemConfig* system_config = new SystemConfig(path);
+  system_configs[path] = system_config;
+  return system_config;
+}
+
+void SystemConfig::clear() {
+  for (auto& system_config : system_configs) {
+    delete system_config.second;
+  }
+  system_configs.clear();
+}
+
+SystemConfig::SystemConfig(string path) {
+  ifstream inFile;
+  inFile.open(path);
+  if (!inFile) {
+    cerr << "Unable to open file: " << path << endl;
+    exit(1);
+  }
+  inFile >> j;
+  inFile.close();
+
+  all_reduce_implementation_per_dimension =
+      parse_collective_implementation("all-reduce-implementation");
+  expand_composite_implementation(
+      "AllReduce", all_reduce_implementation_per_dimension);
+  reduce_scatter_implementation_per_dimension =
+      parse_collective_implementation("reduce-scatter-implementation");
+  expand_composite_implementation(
+      "ReduceScatter", reduce_scatter_implementation_per_dimension);
+  all_gather_implementation_per_dimension =
+      parse_collective_implementation("all-gather-implementation");
+  expand_composite_implementation(
+      "AllGather", all_gather_implementation_per_dimension);
+  all_to_all_implementation_per_dimension =
+      parse_collective_implementation("all-to-all-implementation");
+  expand_composite_implementation(
+      "AllToAll", all_to_all_implementation_per_dimension);
+  // hierarchicalDirect creates two logical dimensions (the fast dimension
+  // and all the remaining dimensions flattened into one group), so its entry
+  // is repeated for the second one. It takes every dimension after its own.
+  for (int dim = 0; dim < all_to_all_implementation_per_dimension.size(); dim++) {
+    CollectiveImpl* ci = all_to_all_implementation_per_dimension[dim];
+    if (ci->type != CollectiveImplType::HierarchicalDirect) {
+      continue;
+    }
+    if (dim != all_to_all_implementation_per_dimension.size() - 1) {
+      Sys::sys_panic("hierarchicalDirect should be the last all-to-all implementation");
+    }
+    all_to_all_implementation_per_dimension.insert(
+        all_to_all_implementation_per_dimension.begin() + dim + 1, ci);
+    break;
+  }
+  rooted_implementation_per_dimension =
+      parse_collective_implementation("rooted-collective-implementation");
+  for (auto ci : rooted_implementation_per_dimension) {
+    if (ci->type != CollectiveImplType::Chain &&
+        ci->type != CollectiveImplType::BinomialTree) {
+      Sys::sys_panic("rooted collectives only support chain and binomialTree implementations");
+    }
+  }
+  default_rooted_implementation =
+      new CollectiveImpl(CollectiveImplType::BinomialTree);
+  owned_implementations.push_back(default_rooted_implementation);
+  autotune_link_latency = 500;
+  if (j.contains("collective-autotune-table")) {
+    string inp_autotune_table = j["collective-autotune-table"];
+    autotune_table = inp_autotune_table;
+  }
+  if (j.contains("collective-autotune-topology")) {
+    vector<string> inp_autotune_topology = j["collective-autotune-topology"];
+    autotune_topology = inp_autotune_topology;
+  }
+  if (j.contains("collective-autotune-link-latency")) {
+    autotune_link_latency = j["collective-autotune-link-latency"];
+  }
+  if (j.contains("parallel-group-sizes")) {
+    vector<int> inp_parallel_group_sizes = j["parallel-group-sizes"];
+    parallel_group_sizes = inp_parallel_group_sizes;
+    for (int size : parallel_group_sizes) {
+      if (size < 1) {
+        Sys::sys_panic("parallel group sizes should be positive");
+      }
+    }
+  }
+}
+
+bool SystemConfig::factorize_dimensions(
+    const vector<int>& physical_dims,
+    const vector<int>& group_sizes,
+    DimensionFactorization& factorization,
+    string& error) {
+  factorization.logical_dims.clear();
+  factorization.physical_dim.clear();
+  int npus_below = 1;
+  int next_group = 0;
+  for (int dim = 0; dim < physical_dims.size(); dim++) {
+    int remaining = physical_dims[dim];
+    // groups that end exactly at a dimension boundary need no cut
+    while (next_group < group_sizes.size() &&
+           group_sizes[next_group] <= npus_below) {
+      if (group_sizes[next_group] != npus_below) {
+        error = "the parallel groups should be nested";
+        return false;
+      }
+      next_group++;
+    }
+    while (next_group < group_sizes.size() &&
+           group_sizes[next_group] < npus_below * remaining) {
+      int group_size = group_sizes[next_group];
+      if (group_size % npus_below != 0 ||
+          remaining % (group_size / npus_below) != 0) {
+        error = "the parallel group of " + to_string(group_size) +
+            " NPUs does not fit the dimension " + to_string(dim) +
+            " of the network";
+        return false;
+      }
+      int cut = group_size / npus_below;
+      factorization.logical_dims.push_back(cut);
+      factorization.physical_dim.push_back(dim);
+      remaining /= cut;
+      npus_below = group_size;
+      next_group++;
+    }
+    factorization.logical_dims.push_back(remaining);
+    factorization.physical_dim.push_back(dim);
+    npus_below *= remaining;
+  }
+  for (; next_group < group_sizes.size(); next_group++) {
+    if (group_sizes[next_group] > npus_below) {
+      error = "the parallel groups are larger than the network";
+      return false;
+    }
+  }
+  return true;
+}
+
+const DimensionFactorization& SystemConfig::get_dimension_factorization(
+    const vector<int>& physical_dims) {
+  auto it = dimension_factorizations.find(physical_dims);
+  if (it != dimension_factorizations.end()) {
+    return it->second;
+  }
+  vector<int> group_sizes;
+  int group_size = 1;
+  for (int size : parallel_group_sizes) {
+    group_size *= size;
+    group_sizes.push_back(group_size);
+  }
+  DimensionFactorization factorization;
+  string error;
+  if (!factorize_dimensions(physical_dims, group_sizes, factorization, error)) {
+    Sys::sys_panic(error);
+  }
+  dimension_factorizations[physical_dims] = factorization;
+  return dimension_factorizations[physical_dims];
+}
+
+CollectiveAutotuner* SystemConfig::get_collective_autotuner(
+    const vector<int>& physical_dims,
+    const vector<double>& dim_BW) {
+  if (autotune_table == "") {
+    return nullptr;
+  }
+  pair<vector<int>, vector<double>> network = make_pair(physical_dims, dim_BW);
+  auto it = collective_autotuners.find(network);
+  if (it != collective_autotuners.end()) {
+    return it->second;
+  }
+  CollectiveAutotuner* autotuner = new CollectiveAutotuner(
+      autotune_table,
+      physical_dims,
+      dim_BW,
+      autotune_topology,
+      autotune_link_latency);
+  collective_autotuners[network] = autotuner;
+  return autotuner;
+}
+
+SystemConfig::~SystemConfig() {
+  for (auto ci : owned_implementations) {
+    delete ci;
+  }
+  for (auto& autotuner : collective_autotuners) {
+    delete autotuner.second;
+  }
+}
+
+vector<CollectiveImpl*> SystemConfig::parse_collective_implementation(
+    string key) {
+  vector<CollectiveImpl*> implementation_per_dimension;
+  if (j.contains(key)) {
+    vector<string> collective_impl_str_vec = j[key];
+    for (auto collective_impl_str : collective_impl_str_vec) {
+      CollectiveImpl* ci =
+          Sys::generate_collective_impl_from_input(collective_impl_str);
+      implementation_per_dimension.push_back(ci);
+      owned_implementations.push_back(ci);
+    }
+  }
+  return implementation_per_dimension;
+}
+
+// Replaces a composite implementation by the algorithm run on each of the 3
+// dimensions of its logical topology. The tree dimensions only carry the
+// all-reduce; the other collectives use the ring of the same NPUs.
+void SystemConfig::expand_composite_implementation(
+    string name,
+    vector<CollectiveImpl*>& implementation_per_dimension) {
+  bool composite = false;
+  for (auto ci : implementation_per_dimension) {
+    if (ci->type == CollectiveImplType::HierarchicalRing ||
+        ci->type == CollectiveImplType::DoubleBinaryTreeLocalAllToAll ||
+        ci->type == CollectiveImplType::LocalRingNodeA2AGlobalDBT) {
+      composite = true;
+    }
+  }
+  if (!composite) {
+    return;
+  }
+  if (implementation_per_dimension.size() != 1) {
+    Sys::sys_panic("hierarchicalRing, doubleBinaryTreeLocalAllToAll and localRingNodeA2AGlobalDBT should be the only implementation of the collective");
+  }
+  CollectiveImplType type = implementation_per_dimension[0]->type;
+  CollectiveImplType global_type = name == "AllReduce"
+      ? CollectiveImplType::DoubleBinaryTree
+      : CollectiveImplType::Ring;
+  composite_topologies[name] = type;
+  implementation_per_dimension.clear();
+  if (type == CollectiveImplType::HierarchicalRing) {
+    implementation_per_dimension.push_back(
+        new CollectiveImpl(CollectiveImplType::Ring));
+    implementation_per_dimension.push_back(
+        new CollectiveImpl(CollectiveImplType::Ring));
+    implementation_per_dimension.push_back(
+        new CollectiveImpl(CollectiveImplType::Ring));
+  } else if (type == CollectiveImplType::DoubleBinaryTreeLocalAllToAll) {
+    // the middle dimension of LocalRingGlobalBinaryTree has a single node
+    implementation_per_dimension.push_back(
+        new DirectCollectiveImpl(CollectiveImplType::Direct, -1));
+    implementation_per_dimension.push_back(
+        new CollectiveImpl(CollectiveImplType::Ring));
+    implementation_per_dimension.push_back(new CollectiveImpl(global_type));
+  } else {
+    implementation_per_dimension.push_back(
+        new CollectiveImpl(CollectiveImplType::Ring));
+    implementation_per_dimension.push_back(
+        new DirectCollectiveImpl(CollectiveImplType::Direct, -1));
+    implementation_per_dimension.push_back(new CollectiveImpl(global_type));
+  }
+  for (auto ci : implementation_per_dimension) {
+    owned_implementations.push_back(ci);
+  }
+}
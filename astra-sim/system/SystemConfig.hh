@@ -0,0 +1,96 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#ifndef __SYSTEM_CONFIG_HH__
+#define __SYSTEM_CONFIG_HH__
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "astra-sim/json.hpp"
+#include "astra-sim/system/Common.hh"
+
+namespace AstraSim {
+
+class CollectiveAutotuner;
+
+// The logical dimensions obtained by cutting the physical dimensions at the
+// boundaries of the nested parallel groups (e.g. a TP group of 4 on a
+// dimension of 8 NPUs cuts it into logical dimensions of 4 and 2 NPUs).
+class DimensionFactorization {
+ public:
+  std::vector<int> logical_dims;
+  // the physical dimension each logical dimension is cut from
+  std::vector<int> physical_dim;
+};
+
+// The parsed system configuration file. It is read once per file and shared
+// by all the Sys instances (one per NPU), together with the collective
+// implementation descriptors, which are immutable and hold no per-rank state.
+// Configurations are owned by the cache and released by clear() once the
+// last Sys is gone.
+class SystemConfig {
+ public:
+  static SystemConfig* get_system_config(std::string path);
+  static void clear();
+  // group_sizes are the cumulative sizes of the nested groups (e.g. TP and
+  // TPxPP); every one of them must fall on a boundary of a physical
+  // dimension or divide the rest of the dimension it cuts; otherwise it
+  // returns false and explains why in error
+  static bool factorize_dimensions(
+      const std::vector<int>& physical_dims,
+      const std::vector<int>& group_sizes,
+      DimensionFactorization& factorization,
+      std::string& error);
+  // the factorization of parallel-group-sizes over a network, computed once
+  // and shared by all the NPUs
+  const DimensionFactorization& get_dimension_factorization(
+      const std::vector<int>& physical_dims);
+  // the collective autotuner of a network, built or loaded once and shared
+  // by all the NPUs; nullptr without collective-autotune-table
+  CollectiveAutotuner* get_collective_autotuner(
+      const std::vector<int>& physical_dims,
+      const std::vector<double>& dim_BW);
+  ~SystemConfig();
+
+  nlohmann::json j;
+  std::vector<CollectiveImpl*> all_reduce_implementation_per_dimension;
+  std::vector<CollectiveImpl*> reduce_scatter_implementation_per_dimension;
+  std::vector<CollectiveImpl*> all_gather_implementation_per_dimension;
+  std::vector<CollectiveImpl*> all_to_all_implementation_per_dimension;
+  std::vector<CollectiveImpl*> rooted_implementation_per_dimension;
+  // used for the dimensions rooted-collective-implementation does not cover
+  CollectiveImpl* default_rooted_implementation;
+  // the collectives (keyed like Sys::logical_topologies) configured with a
+  // composite implementation (hierarchicalRing, doubleBinaryTreeLocalAllToAll
+  // or localRingNodeA2AGlobalDBT), which selects a prebuilt 3-dimensional
+  // logical topology instead of one algorithm per dimension
+  std::map<std::string, CollectiveImplType> composite_topologies;
+  // the degrees of the nested parallel groups, innermost first (e.g. TP, PP)
+  std::vector<int> parallel_group_sizes;
+  std::string autotune_table;
+  std::vector<std::string> autotune_topology;
+  double autotune_link_latency;
+
+ private:
+  SystemConfig(std::string path);
+  std::vector<CollectiveImpl*> parse_collective_implementation(
+      std::string key);
+  void expand_composite_implementation(
+      std::string name,
+      std::vector<CollectiveImpl*>& implementation_per_dimension);
+
+  std::vector<CollectiveImpl*> owned_implementations;
+  std::map<std::vector<int>, DimensionFactorization> dimension_factorizations;
+  std::map<std::pair<std::vector<int>, std::vector<double>>, CollectiveAutotuner*>
+      collective_autotuners;
+  static std::map<std::string, SystemConfig*> system_configs;
+};
+
+} // namespace AstraSim
+
+#endif /* __SYSTEM_CONFIG_HH__ */
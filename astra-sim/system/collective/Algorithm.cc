@@ -9,6 +9,9 @@ using namespace AstraSim;
 
 Algorithm::Algorithm() {
   enabled = true;
+  encode_charged = false;
+  decode_charged = false;
+  decode_pending = false;
 }
 
 void Algorithm::init(BaseStream* stream) {
@@ -16,6 +19,91 @@ void Algorithm::init(BaseStream* stream) {
 }
 
 void Algorithm::call(EventType event, CallData* data) {
+  if (event == EventType::CommProcessingFinished && decode_pending) {
+    decode_pending = false;
+    exit();
+  }
+}
+
+void Algorithm::enable_compression(CompressionConfig compression) {
+  this->compression = compression;
+}
+
+void Algorithm::enable_segmentation(uint64_t segment_size) {
+}
+
+void Algorithm::enable_software_routing() {
+}
+
+Algorithm* Algorithm::clone() const {
+  return nullptr;
+}
+
+Tick Algorithm::get_codec_delay(uint64_t compressed_size) {
+  if (!compression.is_enabled()) {
+    return 0;
+  }
+  // when the compression survives the reduction, the whole data of the phase
+  // is encoded before its first message, and decoded once it ends (see
+  // wait_for_decode)
+  if (compression.survives_reduction) {
+    if (encode_charged) {
+      return 0;
+    }
+    encode_charged = true;
+    return (Tick)(data_size * compression.encode_cost);
+  }
+  double size = compressed_size * compression.ratio;
+  return (Tick)(size * (compression.encode_cost + compression.decode_cost));
+}
+
+// Holds the end of a phase whose compression survives the reduction until
+// its result is decoded. Returns true while the decoding is in progress; the
+// phase exits again once it is done.
+bool Algorithm::wait_for_decode() {
+  if (decode_pending) {
+    return true;
+  }
+  if (decode_charged || !compression.is_enabled() ||
+      !compression.survives_reduction) {
+    return false;
+  }
+  decode_charged = true;
+  Tick delay = (Tick)(final_data_size * compression.decode_cost);
+  if (delay == 0) {
+    return false;
+  }
+  decode_pending = true;
+  stream->owner->try_register_event(
+      this, EventType::CommProcessingFinished, nullptr, delay);
+  return true;
+}
+
+// How many messages a stream may have in flight. normal keeps the count the
+// implementation uses on its own, infinite lets all the messages that do not
+// depend on each other (max_outstanding) go at once, and the policies in between add a quarter, half and three
+// quarters of the difference, so each policy injects at least as much as the
+// previous one.
+int Algorithm::get_injection_window(
+    InjectionPolicy injection_policy,
+    int normal_outstanding,
+    int max_outstanding) {
+  if (max_outstanding <= normal_outstanding) {
+    return normal_outstanding;
+  }
+  int extra = max_outstanding - normal_outstanding;
+  switch (injection_policy) {
+    case InjectionPolicy::Normal:
+      return normal_outstanding;
+    case InjectionPolicy::SemiAggressive:
+      return normal_outstanding + (extra + 3) / 4;
+    case InjectionPolicy::Aggressive:
+      return normal_outstanding + (extra + 1) / 2;
+    case InjectionPolicy::ExtraAggressive:
+      return normal_outstanding + (3 * extra + 3) / 4;
+    default:
+      return max_outstanding;
+  }
 }
 
 void Algorithm::exit() {
@@ -19,7 +19,10 @@ class Algorithm : public Callable {
     Ring = 0,
     DoubleBinaryTree,
     AllToAll,
-    HalvingDoubling};
+    HalvingDoubling,
+    Chain,
+    BinomialTree,
+    InNetwork};
 
   Algorithm();
   virtual ~Algorithm() = default;
@@ -27,6 +30,19 @@ class Algorithm : public Callable {
   virtual void init(BaseStream* stream);
   virtual void call(EventType event, CallData* data);
   virtual void exit();
+  virtual void enable_compression(CompressionConfig compression);
+  virtual void enable_segmentation(uint64_t segment_size);
+  virtual void enable_software_routing();
+  // A fresh copy of an algorithm that has not started yet, used to
+  // instantiate repeated collectives from a template. nullptr if the
+  // algorithm cannot be copied.
+  virtual Algorithm* clone() const;
+  Tick get_codec_delay(uint64_t compressed_size);
+  bool wait_for_decode();
+  static int get_injection_window(
+      InjectionPolicy injection_policy,
+      int normal_outstanding,
+      int max_outstanding);
 
   Name name;
   int id;
@@ -36,6 +52,10 @@ class Algorithm : public Callable {
   uint64_t final_data_size;
   ComType comType;
   bool enabled;
+  CompressionConfig compression;
+  bool encode_charged;
+  bool decode_charged;
+  bool decode_pending;
 };
 
 } // namespace AstraSim
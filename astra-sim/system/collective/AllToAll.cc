@@ -5,20 +5,53 @@ LICENSE file in the root directory of this source tree.
 
 #include "astra-sim/system/collective/AllToAll.hh"
 
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+
+using namespace std;
 using namespace AstraSim;
 
 AllToAll::AllToAll(
     ComType type, int window, int id, RingTopology* allToAllTopology,
-    uint64_t data_size, RingTopology::Direction direction, InjectionPolicy injection_policy)
-    : Ring(type, id, allToAllTopology, data_size, direction, injection_policy) {
+    uint64_t data_size, RingTopology::Direction direction, InjectionPolicy injection_policy,
+    double skew, int sequence)
+    : Ring(type == ComType::All_to_Allv ? ComType::All_to_All : type,
+           id, allToAllTopology, data_size, direction, injection_policy) {
   this->name = Name::AllToAll;
+  this->comType = type;
+  this->peer_recv_size = msg_size;
+  this->peer_recv_remainder = 0;
+  if (type == ComType::All_to_Allv) {
+    // every NPU routes the same share of its data to a given peer, so the
+    // popular peers receive more than the others
+    vector<double> weights = get_peer_weights(nodes_in_ring, skew, sequence);
+    for (int index = 0; index < nodes_in_ring; index++) {
+      peer_send_size.push_back(max((uint64_t)(data_size * weights[index]), (uint64_t)1));
+      peer_send_remainder.push_back(0);
+    }
+    peer_recv_size = peer_send_size[allToAllTopology->get_index_in_ring()];
+  }
+  this->step_receivers = allToAllTopology->get_peers(id, direction);
+  this->step_senders = allToAllTopology->get_peers(
+      id,
+      direction == RingTopology::Direction::Clockwise
+          ? RingTopology::Direction::Anticlockwise
+          : RingTopology::Direction::Clockwise);
+  if (type == ComType::All_to_Allv) {
+    for (int receiver : step_receivers) {
+      step_receiver_indices.push_back(allToAllTopology->get_index_of(receiver));
+    }
+  }
+  set_step(0);
   this->middle_point = nodes_in_ring - 1;
   if (window == -1) {
     parallel_reduce = nodes_in_ring - 1;
   } else {
     parallel_reduce = (int)std::min(window, nodes_in_ring - 1);
   }
-  if (type == ComType::All_to_All) {
+  if (type == ComType::All_to_All || type == ComType::All_to_Allv) {
     this->stream_count = nodes_in_ring - 1;
   }
 }
@@ -30,12 +63,15 @@ void AllToAll::run(EventType event, CallData* data) {
       if (total_packets_received < middle_point) {
         return;
       }
-      for (int i = 0; i < parallel_reduce; i++) {
+      for (int i = 0; i < injection_window; i++) {
         ready();
       }
       iteratable();
     } else {
-      ready();
+      // a relayed hop may become ready after the packets behind it are
+      // processed, so every packet that can go is sent
+      while (forwarded_data_received() && ready()) {
+      }
       iteratable();
     }
 
@@ -44,7 +80,19 @@ void AllToAll::run(EventType event, CallData* data) {
     insert_packet(nullptr);
 
   } else if (event == EventType::StreamInit) {
-    for (int i = 0; i < parallel_reduce; i++) {
+    // the sizes are final once compression and segmentation are configured
+    set_step(step);
+    recv_size = comType == ComType::All_to_Allv ? peer_recv_size : msg_size;
+    recv_remainder =
+        comType == ComType::All_to_Allv ? peer_recv_remainder : msg_remainder;
+    // the messages to the different peers do not depend on each other, so
+    // the injection policy may send them ahead of the window. The gather of
+    // the all-reduce waits for the reduced data, so it is not sent ahead.
+    injection_window = get_injection_window(
+        injection_policy,
+        parallel_reduce,
+        comType == ComType::All_Reduce ? middle_point : stream_count);
+    for (int i = 0; i < injection_window; i++) {
       insert_packet(nullptr);
     }
   }
@@ -58,21 +106,139 @@ void AllToAll::process_max_count() {
     max_count--;
     release_packets();
     remained_packets_per_max_count = 1;
+    // segments cycle over the steps again
+    set_step(step + 1 == (int)step_receivers.size() ? 0 : step + 1);
+  }
+}
 
-    curr_receiver = ((RingTopology*)logical_topo)->get_receiver(curr_receiver, direction);
-    if (curr_receiver == id) {
-      curr_receiver = ((RingTopology*)logical_topo)->get_receiver(curr_receiver, direction);
-    }
+void AllToAll::set_step(int step) {
+  this->step = step;
+  curr_send_size = msg_size;
+  curr_send_remainder = msg_remainder;
+  if (step_receivers.empty()) {
+    return;
+  }
+  curr_receiver = step_receivers[step];
+  curr_sender = step_senders[step];
+  if (comType == ComType::All_to_Allv) {
+    curr_send_size = peer_send_size[step_receiver_indices[step]];
+    curr_send_remainder = peer_send_remainder[step_receiver_indices[step]];
+  }
+}
 
-    curr_sender = ((RingTopology*)logical_topo)->get_sender(curr_sender, direction);
-    if (curr_sender == id) {
-      curr_sender = ((RingTopology*)logical_topo)->get_sender(curr_sender, direction);
+// The message to the peer at distance d is relayed hop by hop by the NPUs on
+// the shorter way around the ring: min(d, n - d) steps, each of which sends
+// to the next NPU on the way and receives what the previous one forwards, so
+// every NPU relays the messages of the others through its memory bus. The
+// first hops of all the messages come first, then the second hops, and so
+// on, and every relayed hop waits for the step it forwards. Only the
+// all-to-all is relayed: the direct all-reduce keeps its peers one hop away,
+// and the all-to-allv sizes depend on the final peer.
+void AllToAll::enable_software_routing() {
+  if (comType != ComType::All_to_All || nodes_in_ring < 3) {
+    return;
+  }
+  int next = ring_topology->get_receiver(id, direction);
+  int previous = ring_topology->get_sender(id, direction);
+  step_receivers.clear();
+  step_senders.clear();
+  step_forwarded.clear();
+  // the last step of the message to each distance
+  vector<int> last_step(nodes_in_ring, -1);
+  for (int hop = 0; hop < nodes_in_ring / 2; hop++) {
+    for (int distance = 1; distance < nodes_in_ring; distance++) {
+      if (hop >= min(distance, nodes_in_ring - distance)) {
+        continue;
+      }
+      bool forward = distance <= nodes_in_ring - distance;
+      step_forwarded.push_back(last_step[distance]);
+      last_step[distance] = step_receivers.size();
+      step_receivers.push_back(forward ? next : previous);
+      step_senders.push_back(forward ? previous : next);
     }
   }
+  stream_count = step_receivers.size();
+  set_step(0);
+}
+
+// Whether the next packet to send can go: a relayed hop forwards what the
+// previous NPU sent at an earlier step, so it waits until as many messages
+// as that step (in the current round of segments) have been received.
+bool AllToAll::forwarded_data_received() {
+  if (step_forwarded.empty()) {
+    return true;
+  }
+  int steps = step_forwarded.size();
+  int next_step = total_packets_sent % steps;
+  if (step_forwarded[next_step] == -1) {
+    return true;
+  }
+  long round_start = total_packets_sent - next_step;
+  return total_packets_received > round_start + step_forwarded[next_step];
+}
+
+Algorithm* AllToAll::clone() const {
+  return new AllToAll(*this);
+}
+
+void AllToAll::enable_compression(CompressionConfig compression) {
+  Ring::enable_compression(compression);
+  for (auto& size : peer_send_size) {
+    size = max((uint64_t)(size / compression.ratio), (uint64_t)1);
+  }
+  peer_recv_size = max((uint64_t)(peer_recv_size / compression.ratio), (uint64_t)1);
+}
+
+void AllToAll::enable_segmentation(uint64_t segment_size) {
+  Ring::enable_segmentation(segment_size);
+  middle_point *= segments;
+  for (int index = 0; index < (int)peer_send_size.size(); index++) {
+    peer_send_remainder[index] = get_segment_remainder(peer_send_size[index]);
+    peer_send_size[index] = max(peer_send_size[index] / segments, (uint64_t)1);
+  }
+  peer_recv_remainder = get_segment_remainder(peer_recv_size);
+  peer_recv_size = max(peer_recv_size / segments, (uint64_t)1);
+}
+
+// The bytes of a message that do not divide evenly into its segments; a
+// message smaller than the segment count sends a byte per segment instead.
+uint64_t AllToAll::get_segment_remainder(uint64_t size) {
+  if (size < (uint64_t)segments) {
+    return 0;
+  }
+  return size % segments;
+}
+
+// The steps take turns, so the segments of a message are one round of steps
+// apart.
+bool AllToAll::is_last_segment(long packet) {
+  long steps = max((long)step_receivers.size(), 1L);
+  return (packet / steps) % segments == segments - 1;
+}
+
+// Zipf-like popularity of the ring indices: the weight of the peer with
+// popularity rank r is proportional to 1/r^skew. The ranking is shuffled with
+// the sequence number of the collective, so all the NPUs agree on it while the
+// hot peers change from one collective to the next.
+vector<double> AllToAll::get_peer_weights(int nodes, double skew, int sequence) {
+  vector<int> rank(nodes);
+  iota(rank.begin(), rank.end(), 1);
+  mt19937 generator(sequence);
+  shuffle(rank.begin(), rank.end(), generator);
+  vector<double> weights(nodes);
+  double total = 0;
+  for (int index = 0; index < nodes; index++) {
+    weights[index] = pow((double)rank[index], -skew);
+    total += weights[index];
+  }
+  for (int index = 0; index < nodes; index++) {
+    weights[index] /= total;
+  }
+  return weights;
 }
 
 int AllToAll::get_non_zero_latency_packets() {
-  if (((RingTopology*)logical_topo)->get_dimension() != RingTopology::Dimension::Local) {
+  if (ring_topology->get_dimension() != RingTopology::Dimension::Local) {
     return parallel_reduce * 1;
   } else {
     return (nodes_in_ring - 1) * parallel_reduce * 1;
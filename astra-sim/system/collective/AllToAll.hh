@@ -6,6 +6,8 @@ LICENSE file in the root directory of this source tree.
 #ifndef __ALL_TO_ALL_HH__
 #define __ALL_TO_ALL_HH__
 
+#include <vector>
+
 #include "astra-sim/system/collective/Ring.hh"
 #include "astra-sim/system/CallData.hh"
 #include "astra-sim/system/topology/RingTopology.hh"
@@ -16,11 +18,37 @@ class AllToAll : public Ring {
  public:
   AllToAll(
       ComType type, int window, int id, RingTopology* allToAllTopology,
-      uint64_t data_size, RingTopology::Direction direction, InjectionPolicy injection_policy);
+      uint64_t data_size, RingTopology::Direction direction, InjectionPolicy injection_policy,
+      double skew = 0, int sequence = 0);
   void run(EventType event, CallData* data);
   void process_max_count();
   int get_non_zero_latency_packets();
+  void enable_compression(CompressionConfig compression);
+  void enable_segmentation(uint64_t segment_size);
+  uint64_t get_segment_remainder(uint64_t size);
+  bool is_last_segment(long packet);
+  void enable_software_routing();
+  bool forwarded_data_received();
+  void set_step(int step);
+  Algorithm* clone() const;
+  static std::vector<double> get_peer_weights(int nodes, double skew, int sequence);
   int middle_point;
+  // all-to-allv: bytes sent to each index of the ring, and received from
+  // every peer, plus what their last segments carry on top
+  std::vector<uint64_t> peer_send_size;
+  std::vector<uint64_t> peer_send_remainder;
+  uint64_t peer_recv_size;
+  uint64_t peer_recv_remainder;
+  // the receiver and sender of every step, resolved once so that moving to
+  // the next step is an index increment, and the ring index of the receiver
+  // (all-to-allv)
+  std::vector<int> step_receivers;
+  std::vector<int> step_senders;
+  std::vector<int> step_receiver_indices;
+  // software routing: the step whose message each step forwards, -1 for the
+  // first hops
+  std::vector<int> step_forwarded;
+  int step;
 };
 
 } // namespace AstraSim
@@ -0,0 +1,115 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "astra-sim/system/collective/BinomialTree.hh"
+
+using namespace std;
+using namespace AstraSim;
+
+BinomialTree::BinomialTree(
+    ComType type,
+    int id,
+    RingTopology* ring_topology,
+    uint64_t data_size,
+    int root_index)
+    : RootedCollective(type, id, ring_topology, data_size, root_index) {
+  this->name = Name::BinomialTree;
+  int q = position;
+  vector<int> children = get_children(q);
+  switch (type) {
+    case ComType::Broadcast:
+      if (q > 0) {
+        steps.push_back(Step(
+            Step::Kind::Receive,
+            get_node_at_position(get_parent(q)),
+            data_size,
+            false));
+      }
+      for (auto child : children) {
+        steps.push_back(Step(
+            Step::Kind::Send, get_node_at_position(child), data_size, false));
+      }
+      break;
+    case ComType::Reduce:
+      // the child with the largest offset has the smallest subtree and is
+      // the first one to be ready
+      for (auto it = children.rbegin(); it != children.rend(); ++it) {
+        steps.push_back(Step(
+            Step::Kind::Receive, get_node_at_position(*it), data_size, true));
+      }
+      if (q > 0) {
+        steps.push_back(Step(
+            Step::Kind::Send,
+            get_node_at_position(get_parent(q)),
+            data_size,
+            false));
+      }
+      break;
+    case ComType::Gather:
+      for (auto it = children.rbegin(); it != children.rend(); ++it) {
+        steps.push_back(Step(
+            Step::Kind::Receive,
+            get_node_at_position(*it),
+            get_subtree_size(*it) * block_size,
+            false));
+      }
+      if (q > 0) {
+        steps.push_back(Step(
+            Step::Kind::Send,
+            get_node_at_position(get_parent(q)),
+            get_subtree_size(q) * block_size,
+            false));
+      }
+      break;
+    case ComType::Scatter:
+      if (q > 0) {
+        steps.push_back(Step(
+            Step::Kind::Receive,
+            get_node_at_position(get_parent(q)),
+            get_subtree_size(q) * block_size,
+            false));
+      }
+      for (auto child : children) {
+        steps.push_back(Step(
+            Step::Kind::Send,
+            get_node_at_position(child),
+            get_subtree_size(child) * block_size,
+            false));
+      }
+      break;
+    default:
+      Sys::sys_panic("binomial tree only supports rooted collectives");
+  }
+}
+
+int BinomialTree::get_parent(int q) {
+  int mask = 1;
+  while (mask * 2 <= q) {
+    mask *= 2;
+  }
+  return q - mask;
+}
+
+vector<int> BinomialTree::get_children(int q) {
+  vector<int> children;
+  int mask = 1;
+  if (q > 0) {
+    while (mask <= q) {
+      mask *= 2;
+    }
+  }
+  for (; q + mask < nodes_in_ring; mask *= 2) {
+    children.push_back(q + mask);
+  }
+  return children;
+}
+
+int BinomialTree::get_subtree_size(int q) {
+  int size = 1;
+  for (auto child : get_children(q)) {
+    size += get_subtree_size(child);
+  }
+  return size;
+}
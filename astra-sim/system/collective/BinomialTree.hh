@@ -0,0 +1,33 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#ifndef __BINOMIAL_TREE_HH__
+#define __BINOMIAL_TREE_HH__
+
+#include <vector>
+
+#include "astra-sim/system/collective/RootedCollective.hh"
+
+namespace AstraSim {
+
+// Binomial tree over the ring positions counted from the root: position q
+// has parent q - 2^floor(log2(q)) and children q + 2^k for every
+// 2^k > 2^floor(log2(q)). Finishes in ceil(log2(n)) rounds.
+class BinomialTree : public RootedCollective {
+ public:
+  BinomialTree(
+      ComType type,
+      int id,
+      RingTopology* ring_topology,
+      uint64_t data_size,
+      int root_index);
+  int get_parent(int q);
+  std::vector<int> get_children(int q);
+  int get_subtree_size(int q);
+};
+
+} // namespace AstraSim
+
+#endif /* __BINOMIAL_TREE_HH__ */
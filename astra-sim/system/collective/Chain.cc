@@ -0,0 +1,76 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "astra-sim/system/collective/Chain.hh"
+
+using namespace AstraSim;
+
+Chain::Chain(
+    ComType type,
+    int id,
+    RingTopology* ring_topology,
+    uint64_t data_size,
+    int root_index)
+    : RootedCollective(type, id, ring_topology, data_size, root_index) {
+  this->name = Name::Chain;
+  int n = nodes_in_ring;
+  int q = position;
+  switch (type) {
+    case ComType::Broadcast:
+      if (q > 0) {
+        steps.push_back(Step(
+            Step::Kind::Receive, get_node_at_position(q - 1), data_size, false));
+      }
+      if (q < n - 1) {
+        steps.push_back(Step(
+            Step::Kind::Send, get_node_at_position(q + 1), data_size, false));
+      }
+      break;
+    case ComType::Reduce:
+      if (q < n - 1) {
+        steps.push_back(Step(
+            Step::Kind::Receive, get_node_at_position(q + 1), data_size, true));
+      }
+      if (q > 0) {
+        steps.push_back(Step(
+            Step::Kind::Send, get_node_at_position(q - 1), data_size, false));
+      }
+      break;
+    case ComType::Gather:
+      if (q < n - 1) {
+        steps.push_back(Step(
+            Step::Kind::Receive,
+            get_node_at_position(q + 1),
+            (n - 1 - q) * block_size,
+            false));
+      }
+      if (q > 0) {
+        steps.push_back(Step(
+            Step::Kind::Send,
+            get_node_at_position(q - 1),
+            (n - q) * block_size,
+            false));
+      }
+      break;
+    case ComType::Scatter:
+      if (q > 0) {
+        steps.push_back(Step(
+            Step::Kind::Receive,
+            get_node_at_position(q - 1),
+            (n - q) * block_size,
+            false));
+      }
+      if (q < n - 1) {
+        steps.push_back(Step(
+            Step::Kind::Send,
+            get_node_at_position(q + 1),
+            (n - q - 1) * block_size,
+            false));
+      }
+      break;
+    default:
+      Sys::sys_panic("chain only supports rooted collectives");
+  }
+}
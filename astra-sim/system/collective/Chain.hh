@@ -0,0 +1,27 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#ifndef __CHAIN_HH__
+#define __CHAIN_HH__
+
+#include "astra-sim/system/collective/RootedCollective.hh"
+
+namespace AstraSim {
+
+// Pipelined chain: data flows along the ring order starting from (or ending
+// at) the root. Chunks of the same collective pipeline over the chain.
+class Chain : public RootedCollective {
+ public:
+  Chain(
+      ComType type,
+      int id,
+      RingTopology* ring_topology,
+      uint64_t data_size,
+      int root_index);
+};
+
+} // namespace AstraSim
+
+#endif /* __CHAIN_HH__ */
@@ -5,6 +5,7 @@ LICENSE file in the root directory of this source tree.
 
 #include "astra-sim/system/collective/HalvingDoubling.hh"
 
+#include <algorithm>
 #include <cmath>
 #include <iostream>
 
@@ -28,6 +29,7 @@ HalvingDoubling::HalvingDoubling(
   this->total_packets_sent = 0;
   this->total_packets_received = 0;
   this->free_packets = 0;
+  this->locked_packets = 0;
   this->zero_latency_packets = 0;
   this->non_zero_latency_packets = 0;
   this->toggle = false;
@@ -111,38 +113,42 @@ void HalvingDoubling::run(EventType event, CallData* data) {
     total_packets_received++;
     insert_packet(nullptr);
   } else if (event == EventType::StreamInit) {
+    // every step sends what the previous one received, so the injection
+    // policy does not let a stream run ahead of its steps
+    packets.reserve(parallel_reduce);
     for (int i = 0; i < parallel_reduce; i++) {
       insert_packet(nullptr);
     }
   }
 }
 
+Algorithm* HalvingDoubling::clone() const {
+  return new HalvingDoubling(*this);
+}
+
+void HalvingDoubling::enable_compression(CompressionConfig compression) {
+  Algorithm::enable_compression(compression);
+  msg_size = std::max((uint64_t)(msg_size / compression.ratio), (uint64_t)1);
+}
+
 void HalvingDoubling::release_packets() {
-  for (auto packet : locked_packets) {
-    packet->set_notifier(this);
-  }
+  PacketBundle* packet_bundle = new PacketBundle(
+      stream->owner,
+      stream,
+      &packets,
+      packets.end_sequence() - locked_packets,
+      locked_packets,
+      processed,
+      send_back,
+      msg_size,
+      transmition);
+  packet_bundle->codec_delay = get_codec_delay(msg_size);
   if (NPU_to_MA == true) {
-    (new PacketBundle(
-         stream->owner,
-         stream,
-         locked_packets,
-         processed,
-         send_back,
-         msg_size,
-         transmition))
-        ->send_to_MA();
+    packet_bundle->send_to_MA();
   } else {
-    (new PacketBundle(
-         stream->owner,
-         stream,
-         locked_packets,
-         processed,
-         send_back,
-         msg_size,
-         transmition))
-        ->send_to_NPU();
+    packet_bundle->send_to_NPU();
   }
-  locked_packets.clear();
+  locked_packets = 0;
 }
 
 void HalvingDoubling::process_stream_count() {
@@ -210,13 +216,13 @@ void HalvingDoubling::insert_packet(Callable* sender) {
     toggle = !toggle;
   }
   if (zero_latency_packets > 0) {
-    packets.push_back(MyPacket(
-        msg_size,
+    packets.push_back(
         stream->current_queue_id,
         curr_sender,
-        curr_receiver)); // vnet Must be changed for alltoall topology
-    packets.back().sender = sender;
-    locked_packets.push_back(&packets.back());
+        curr_receiver,
+        stream->stream_id,
+        msg_size); // vnet Must be changed for alltoall topology
+    locked_packets++;
     processed = false;
     send_back = false;
     NPU_to_MA = true;
@@ -224,13 +230,13 @@ void HalvingDoubling::insert_packet(Callable* sender) {
     zero_latency_packets--;
     return;
   } else if (non_zero_latency_packets > 0) {
-    packets.push_back(MyPacket(
-        msg_size,
+    packets.push_back(
         stream->current_queue_id,
         curr_sender,
-        curr_receiver)); // vnet Must be changed for alltoall topology
-    packets.back().sender = sender;
-    locked_packets.push_back(&packets.back());
+        curr_receiver,
+        stream->stream_id,
+        msg_size); // vnet Must be changed for alltoall topology
+    locked_packets++;
     if (comType == ComType::Reduce_Scatter ||
         (comType == ComType::All_Reduce && toggle)) {
       processed = true;
@@ -259,7 +265,7 @@ bool HalvingDoubling::ready() {
       free_packets == 0) {
     return false;
   }
-  MyPacket packet = packets.front();
+  PacketDescriptor& packet = packets.front();
   sim_request snd_req;
   snd_req.srcRank = id;
   snd_req.dstRank = packet.preferred_dest;
@@ -302,8 +308,9 @@ void HalvingDoubling::exit() {
   if (packets.size() != 0) {
     packets.clear();
   }
-  if (locked_packets.size() != 0) {
-    locked_packets.clear();
+  locked_packets = 0;
+  if (wait_for_decode()) {
+    return;
   }
   stream->owner->proceed_to_next_vnet_baseline((StreamBaseline*)stream);
 }
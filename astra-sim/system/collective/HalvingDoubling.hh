@@ -10,7 +10,7 @@ LICENSE file in the root directory of this source tree.
 
 #include "astra-sim/system/collective/Algorithm.hh"
 #include "astra-sim/system/MemBus.hh"
-#include "astra-sim/system/MyPacket.hh"
+#include "astra-sim/system/PacketQueue.hh"
 #include "astra-sim/system/topology/RingTopology.hh"
 
 namespace AstraSim {
@@ -31,6 +31,8 @@ class HalvingDoubling : public Algorithm {
   void insert_packet(Callable* sender);
   bool ready();
   void exit();
+  virtual void enable_compression(CompressionConfig compression);
+  virtual Algorithm* clone() const;
 
   RingTopology::Direction dimension;
   MemBus::Transmition transmition;
@@ -47,13 +49,13 @@ class HalvingDoubling : public Algorithm {
   int parallel_reduce;
   PacketRouting routing;
   InjectionPolicy injection_policy;
-  std::list<MyPacket> packets;
+  PacketQueue packets;
   bool toggle;
   long free_packets;
   long total_packets_sent;
   long total_packets_received;
   uint64_t msg_size;
-  std::list<MyPacket*> locked_packets;
+  int locked_packets;
   bool processed;
   bool send_back;
   bool NPU_to_MA;
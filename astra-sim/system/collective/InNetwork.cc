@@ -0,0 +1,127 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "astra-sim/system/collective/InNetwork.hh"
+
+#include <algorithm>
+
+#include "astra-sim/system/PacketBundle.hh"
+#include "astra-sim/system/RecvPacketEventHandlerData.hh"
+
+using namespace std;
+using namespace AstraSim;
+
+InNetwork::InNetwork(
+    ComType type,
+    int id,
+    RingTopology* ring_topology,
+    uint64_t data_size,
+    Tick reduction_delay)
+    : Algorithm() {
+  this->name = Name::InNetwork;
+  this->comType = type;
+  this->id = id;
+  this->logical_topo = ring_topology;
+  this->data_size = data_size;
+  this->nodes_in_ring = ring_topology->get_nodes_in_ring();
+  this->receiver =
+      ring_topology->get_receiver(id, RingTopology::Direction::Clockwise);
+  this->sender =
+      ring_topology->get_sender(id, RingTopology::Direction::Clockwise);
+  this->state = State::Begin;
+  this->reduction_delay = 0;
+  switch (type) {
+    case ComType::All_Reduce:
+      final_data_size = data_size;
+      msg_size = data_size;
+      this->reduction_delay = reduction_delay;
+      break;
+    case ComType::Reduce_Scatter:
+      final_data_size = data_size / nodes_in_ring;
+      msg_size = data_size;
+      this->reduction_delay = reduction_delay;
+      break;
+    case ComType::All_Gather:
+      // the switch multicasts the data of the other NPUs
+      final_data_size = data_size * nodes_in_ring;
+      msg_size = data_size * (nodes_in_ring - 1);
+      break;
+    default:
+      Sys::sys_panic("in-network collectives only support all-reduce, reduce-scatter and all-gather");
+  }
+}
+
+Algorithm* InNetwork::clone() const {
+  return new InNetwork(*this);
+}
+
+void InNetwork::run(EventType event, CallData* data) {
+  if (event == EventType::StreamInit) {
+    state = State::WaitingForResult;
+    sim_request rcv_req;
+    rcv_req.vnet = this->stream->current_queue_id;
+    RecvPacketEventHandlerData* ehd = new RecvPacketEventHandlerData(
+        stream,
+        stream->owner->id,
+        EventType::PacketReceived,
+        stream->current_queue_id,
+        stream->stream_id);
+    stream->owner->front_end_sim_recv(
+        0,
+        Sys::dummy_data,
+        msg_size,
+        UINT8,
+        sender,
+        stream->stream_id,
+        &rcv_req,
+        &Sys::handleEvent,
+        ehd);
+    sim_request snd_req;
+    snd_req.srcRank = id;
+    snd_req.dstRank = receiver;
+    snd_req.tag = stream->stream_id;
+    snd_req.reqType = UINT8;
+    snd_req.vnet = this->stream->current_queue_id;
+    stream->owner->front_end_sim_send(
+        0,
+        Sys::dummy_data,
+        msg_size,
+        UINT8,
+        receiver,
+        stream->stream_id,
+        &snd_req,
+        &Sys::handleEvent,
+        nullptr);
+  } else if (
+      event == EventType::PacketReceived && state == State::WaitingForResult) {
+    state = State::Reducing;
+    if (reduction_delay > 0) {
+      stream->owner->register_event(
+          this, EventType::Processing_Finished, nullptr, reduction_delay);
+    } else {
+      call(EventType::Processing_Finished, nullptr);
+    }
+  } else if (event == EventType::General && state == State::Copying) {
+    state = State::End;
+    exit();
+  }
+}
+
+void InNetwork::call(EventType event, CallData* data) {
+  if (event != EventType::Processing_Finished || state != State::Reducing) {
+    return;
+  }
+  // the result is already reduced by the switch, it only has to be moved to
+  // the NPU
+  state = State::Copying;
+  (new PacketBundle(
+       stream->owner,
+       stream,
+       false,
+       false,
+       final_data_size,
+       MemBus::Transmition::Usual))
+      ->send_to_NPU();
+}
@@ -0,0 +1,45 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#ifndef __IN_NETWORK_HH__
+#define __IN_NETWORK_HH__
+
+#include "astra-sim/system/collective/Algorithm.hh"
+#include "astra-sim/system/CallData.hh"
+#include "astra-sim/system/topology/RingTopology.hh"
+
+namespace AstraSim {
+
+// In-network (switch-offloaded) collective. Every NPU sends its data once to
+// the switch of the dimension, which reduces (or multicasts) it and sends the
+// result back. The network API only connects NPUs, so the round trip through
+// the switch is modeled as one exchange between ring neighbors of the larger
+// of the upstream and downstream sizes (links are full duplex), followed by
+// the reduction time of the switch.
+class InNetwork : public Algorithm {
+ public:
+  enum class State { Begin = 0, WaitingForResult, Reducing, Copying, End };
+
+  InNetwork(
+      ComType type,
+      int id,
+      RingTopology* ring_topology,
+      uint64_t data_size,
+      Tick reduction_delay);
+  void run(EventType event, CallData* data);
+  void call(EventType event, CallData* data);
+  Algorithm* clone() const;
+
+  State state;
+  int receiver;
+  int sender;
+  int nodes_in_ring;
+  uint64_t msg_size;
+  Tick reduction_delay;
+};
+
+} // namespace AstraSim
+
+#endif /* __IN_NETWORK_HH__ */
@@ -5,6 +5,8 @@ LICENSE file in the root directory of this source tree.
 
 #include "astra-sim/system/collective/Ring.hh"
 
+#include <algorithm>
+
 #include "astra-sim/system/PacketBundle.hh"
 #include "astra-sim/system/RecvPacketEventHandlerData.hh"
 
@@ -21,16 +23,25 @@ Ring::Ring(
   this->comType = type;
   this->id = id;
   this->logical_topo = ring_topology;
+  this->ring_topology = ring_topology;
   this->data_size = data_size;
   this->direction = direction;
   this->nodes_in_ring = ring_topology->get_nodes_in_ring();
   this->curr_receiver = ring_topology->get_receiver(id, direction);
   this->curr_sender = ring_topology->get_sender(id, direction);
+  this->curr_send_size = 0;
+  this->curr_send_remainder = 0;
+  this->recv_size = 0;
+  this->recv_remainder = 0;
+  this->msg_remainder = 0;
   this->parallel_reduce = 1;
+  this->segments = 1;
   this->injection_policy = injection_policy;
+  this->injection_window = 0;
   this->total_packets_sent = 0;
   this->total_packets_received = 0;
   this->free_packets = 0;
+  this->locked_packets = 0;
   this->zero_latency_packets = 0;
   this->non_zero_latency_packets = 0;
   this->toggle = false;
@@ -46,17 +57,6 @@ Ring::Ring(
       break;
     case ComType::All_to_All:
       this->stream_count = ((nodes_in_ring - 1) * nodes_in_ring) / 2;
-      switch (injection_policy) {
-        case InjectionPolicy::Aggressive:
-          this->parallel_reduce = nodes_in_ring - 1;
-          break;
-        case InjectionPolicy::Normal:
-          this->parallel_reduce = 1;
-          break;
-        default:
-          this->parallel_reduce = 1;
-          break;
-      }
       break;
     default:
       stream_count = nodes_in_ring - 1;
@@ -89,6 +89,35 @@ Ring::Ring(
   }
 }
 
+Algorithm* Ring::clone() const {
+  return new Ring(*this);
+}
+
+void Ring::enable_compression(CompressionConfig compression) {
+  Algorithm::enable_compression(compression);
+  msg_size = std::max((uint64_t)(msg_size / compression.ratio), (uint64_t)1);
+}
+
+// Every message is cut into segments that flow through the step as separate
+// packets, so the reduction of a segment overlaps with the reception of the
+// next ones instead of waiting for the whole message. The bytes that do not
+// divide evenly go with the last segment.
+void Ring::enable_segmentation(uint64_t segment_size) {
+  if (msg_size <= segment_size) {
+    return;
+  }
+  segments = (msg_size + segment_size - 1) / segment_size;
+  msg_remainder = msg_size % segments;
+  msg_size = msg_size / segments;
+  stream_count *= segments;
+  parallel_reduce *= segments;
+}
+
+// The segments of a message are consecutive packets of the stream.
+bool Ring::is_last_segment(long packet) {
+  return packet % segments == segments - 1;
+}
+
 int Ring::get_non_zero_latency_packets() {
   return (nodes_in_ring - 1) * parallel_reduce * 1;
 }
@@ -102,38 +131,40 @@ void Ring::run(EventType event, CallData* data) {
     total_packets_received++;
     insert_packet(nullptr);
   } else if (event == EventType::StreamInit) {
-    for (int i = 0; i < parallel_reduce; i++) {
+    curr_send_size = msg_size;
+    curr_send_remainder = msg_remainder;
+    recv_size = msg_size;
+    recv_remainder = msg_remainder;
+    // every packet in flight is replaced when a message is received, so the
+    // packets inserted here are the messages the stream may have in flight.
+    // A step forwards what the previous one received, so only the segments
+    // of one step (parallel_reduce) are in flight, whatever the policy.
+    injection_window = parallel_reduce;
+    packets.reserve(injection_window);
+    for (int i = 0; i < injection_window; i++) {
       insert_packet(nullptr);
     }
   }
 }
 
 void Ring::release_packets() {
-  for (auto packet : locked_packets) {
-    packet->set_notifier(this);
-  }
+  PacketBundle* packet_bundle = new PacketBundle(
+      stream->owner,
+      stream,
+      &packets,
+      packets.end_sequence() - locked_packets,
+      locked_packets,
+      processed,
+      send_back,
+      msg_size,
+      transmition);
+  packet_bundle->codec_delay = get_codec_delay(msg_size);
   if (NPU_to_MA == true) {
-    (new PacketBundle(
-         stream->owner,
-         stream,
-         locked_packets,
-         processed,
-         send_back,
-         msg_size,
-         transmition))
-        ->send_to_MA();
+    packet_bundle->send_to_MA();
   } else {
-    (new PacketBundle(
-         stream->owner,
-         stream,
-         locked_packets,
-         processed,
-         send_back,
-         msg_size,
-         transmition))
-        ->send_to_NPU();
+    packet_bundle->send_to_NPU();
   }
-  locked_packets.clear();
+  locked_packets = 0;
 }
 
 void Ring::process_stream_count() {
@@ -173,7 +204,7 @@ void Ring::reduce() {
 
 bool Ring::iteratable() {
   if (stream_count == 0 &&
-      free_packets == (parallel_reduce * 1)) { // && not_delivered==0
+      free_packets == injection_window) { // && not_delivered==0
     exit();
     return false;
   }
@@ -187,13 +218,18 @@ void Ring::insert_packet(Callable* sender) {
         get_non_zero_latency_packets(); //(nodes_in_ring-1)*parallel_reduce*1;
     toggle = !toggle;
   }
+  uint64_t send_size = curr_send_size;
+  if (is_last_segment(total_packets_sent + packets.size())) {
+    send_size += curr_send_remainder;
+  }
   if (zero_latency_packets > 0) {
-    packets.push_back(MyPacket(
+    packets.push_back(
         stream->current_queue_id,
         curr_sender,
-        curr_receiver)); // vnet Must be changed for alltoall topology
-    packets.back().sender = sender;
-    locked_packets.push_back(&packets.back());
+        curr_receiver,
+        stream->stream_id,
+        send_size); // vnet Must be changed for alltoall topology
+    locked_packets++;
     processed = false;
     send_back = false;
     NPU_to_MA = true;
@@ -201,12 +237,13 @@ void Ring::insert_packet(Callable* sender) {
     zero_latency_packets--;
     return;
   } else if (non_zero_latency_packets > 0) {
-    packets.push_back(MyPacket(
+    packets.push_back(
         stream->current_queue_id,
         curr_sender,
-        curr_receiver)); // vnet Must be changed for alltoall topology
-    packets.back().sender = sender;
-    locked_packets.push_back(&packets.back());
+        curr_receiver,
+        stream->stream_id,
+        send_size); // vnet Must be changed for alltoall topology
+    locked_packets++;
     if (comType == ComType::Reduce_Scatter ||
         (comType == ComType::All_Reduce && toggle)) {
       processed = true;
@@ -235,7 +272,7 @@ bool Ring::ready() {
       free_packets == 0) {
     return false;
   }
-  MyPacket packet = packets.front();
+  PacketDescriptor& packet = packets.front();
   sim_request snd_req;
   snd_req.srcRank = id;
   snd_req.dstRank = packet.preferred_dest;
@@ -245,7 +282,7 @@ bool Ring::ready() {
   stream->owner->front_end_sim_send(
       0,
       Sys::dummy_data,
-      msg_size,
+      packet.msg_size,
       UINT8,
       packet.preferred_dest,
       stream->stream_id,
@@ -254,6 +291,11 @@ bool Ring::ready() {
       nullptr); // stream_id+(packet.preferred_dest*50)
   sim_request rcv_req;
   rcv_req.vnet = this->stream->current_queue_id;
+  // the peer sends the same segment of its message in this step
+  uint64_t packet_recv_size = recv_size;
+  if (is_last_segment(total_packets_sent)) {
+    packet_recv_size += recv_remainder;
+  }
   RecvPacketEventHandlerData* ehd = new RecvPacketEventHandlerData(
       stream,
       stream->owner->id,
@@ -263,7 +305,7 @@ bool Ring::ready() {
   stream->owner->front_end_sim_recv(
       0,
       Sys::dummy_data,
-      msg_size,
+      packet_recv_size,
       UINT8,
       packet.preferred_src,
       stream->stream_id,
@@ -278,8 +320,9 @@ void Ring::exit() {
   if (packets.size() != 0) {
     packets.clear();
   }
-  if (locked_packets.size() != 0) {
-    locked_packets.clear();
+  locked_packets = 0;
+  if (wait_for_decode()) {
+    return;
   }
   stream->owner->proceed_to_next_vnet_baseline((StreamBaseline*)stream);
   return;
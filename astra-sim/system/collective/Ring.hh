@@ -8,7 +8,7 @@ LICENSE file in the root directory of this source tree.
 
 #include "astra-sim/system/collective/Algorithm.hh"
 #include "astra-sim/system/MemBus.hh"
-#include "astra-sim/system/MyPacket.hh"
+#include "astra-sim/system/PacketQueue.hh"
 #include "astra-sim/system/topology/RingTopology.hh"
 
 namespace AstraSim {
@@ -32,7 +32,12 @@ class Ring : public Algorithm {
   void insert_packet(Callable* sender);
   bool ready();
   void exit();
+  virtual void enable_compression(CompressionConfig compression);
+  virtual void enable_segmentation(uint64_t segment_size);
+  virtual bool is_last_segment(long packet);
+  virtual Algorithm* clone() const;
 
+  RingTopology* ring_topology;
   RingTopology::Direction dimension;
   RingTopology::Direction direction;
   MemBus::Transmition transmition;
@@ -47,14 +52,24 @@ class Ring : public Algorithm {
   int remained_packets_per_max_count;
   int remained_packets_per_message;
   int parallel_reduce;
+  int segments;
   InjectionPolicy injection_policy;
-  std::list<MyPacket> packets;
+  int injection_window;
+  PacketQueue packets;
   bool toggle;
   long free_packets;
   long total_packets_sent;
   long total_packets_received;
   uint64_t msg_size;
-  std::list<MyPacket*> locked_packets;
+  // bytes the last segment of every message carries on top of msg_size
+  uint64_t msg_remainder;
+  // bytes of the next packet sent, and of every message received, plus what
+  // their last segments carry on top
+  uint64_t curr_send_size;
+  uint64_t curr_send_remainder;
+  uint64_t recv_size;
+  uint64_t recv_remainder;
+  int locked_packets;
   bool processed;
   bool send_back;
   bool NPU_to_MA;
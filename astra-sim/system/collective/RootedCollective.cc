@@ -0,0 +1,114 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "astra-sim/system/collective/RootedCollective.hh"
+
+#include "astra-sim/system/PacketBundle.hh"
+#include "astra-sim/system/RecvPacketEventHandlerData.hh"
+
+using namespace AstraSim;
+
+RootedCollective::RootedCollective(
+    ComType type,
+    int id,
+    RingTopology* ring_topology,
+    uint64_t data_size,
+    int root_index)
+    : Algorithm() {
+  this->comType = type;
+  this->id = id;
+  this->logical_topo = ring_topology;
+  this->ring_topology = ring_topology;
+  this->data_size = data_size;
+  this->nodes_in_ring = ring_topology->get_nodes_in_ring();
+  this->root_index = root_index;
+  // position of this NPU in the ring, counted from the root
+  this->position =
+    (ring_topology->get_index_in_ring() - root_index + nodes_in_ring)
+    % nodes_in_ring;
+  switch (type) {
+    case ComType::Gather:
+      block_size = data_size;
+      final_data_size = data_size * nodes_in_ring;
+      break;
+    case ComType::Scatter:
+      block_size = data_size / nodes_in_ring;
+      final_data_size = data_size / nodes_in_ring;
+      break;
+    default:
+      block_size = data_size;
+      final_data_size = data_size;
+  }
+}
+
+int RootedCollective::get_node_at_position(int position) {
+  return ring_topology->get_node_id_at_index(
+      (position + root_index) % nodes_in_ring);
+}
+
+void RootedCollective::run(EventType event, CallData* data) {
+  if (event == EventType::StreamInit) {
+    proceed();
+  } else if (event == EventType::PacketReceived) {
+    Step& step = steps.front();
+    (new PacketBundle(
+         stream->owner,
+         stream,
+         step.reduce,
+         false,
+         step.size,
+         MemBus::Transmition::Usual))
+        ->send_to_NPU();
+  } else if (event == EventType::General) {
+    steps.pop_front();
+    proceed();
+  }
+}
+
+void RootedCollective::proceed() {
+  while (!steps.empty() && steps.front().kind == Step::Kind::Send) {
+    Step& step = steps.front();
+    sim_request snd_req;
+    snd_req.srcRank = stream->owner->id;
+    snd_req.dstRank = step.peer;
+    snd_req.tag = stream->stream_id;
+    snd_req.reqType = UINT8;
+    snd_req.vnet = this->stream->current_queue_id;
+    stream->owner->front_end_sim_send(
+        0,
+        Sys::dummy_data,
+        step.size,
+        UINT8,
+        step.peer,
+        stream->stream_id,
+        &snd_req,
+        &Sys::handleEvent,
+        nullptr);
+    steps.pop_front();
+  }
+  if (steps.empty()) {
+    exit();
+    return;
+  }
+  Step& step = steps.front();
+  sim_request rcv_req;
+  rcv_req.vnet = this->stream->current_queue_id;
+  RecvPacketEventHandlerData* ehd = new RecvPacketEventHandlerData(
+      stream,
+      stream->owner->id,
+      EventType::PacketReceived,
+      stream->current_queue_id,
+      stream->stream_id);
+  stream->owner->front_end_sim_recv(
+      0,
+      Sys::dummy_data,
+      step.size,
+      UINT8,
+      step.peer,
+      stream->stream_id,
+      &rcv_req,
+      &Sys::handleEvent,
+      ehd);
+}
@@ -0,0 +1,58 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#ifndef __ROOTED_COLLECTIVE_HH__
+#define __ROOTED_COLLECTIVE_HH__
+
+#include <list>
+
+#include "astra-sim/system/collective/Algorithm.hh"
+#include "astra-sim/system/topology/RingTopology.hh"
+
+namespace AstraSim {
+
+// Base of the rooted collectives (broadcast, reduce, gather and scatter).
+// Subclasses fill the list of steps of this NPU, which are then executed in
+// order: sends are issued right away, a receive blocks until the message has
+// arrived and has been moved (and reduced, if needed) to the NPU.
+class RootedCollective : public Algorithm {
+ public:
+  class Step {
+   public:
+    enum class Kind { Send = 0, Receive };
+    Step(Kind kind, int peer, uint64_t size, bool reduce) {
+      this->kind = kind;
+      this->peer = peer;
+      this->size = size;
+      this->reduce = reduce;
+    }
+
+    Kind kind;
+    int peer;
+    uint64_t size;
+    bool reduce;
+  };
+
+  RootedCollective(
+      ComType type,
+      int id,
+      RingTopology* ring_topology,
+      uint64_t data_size,
+      int root_index);
+  virtual void run(EventType event, CallData* data);
+  void proceed();
+  int get_node_at_position(int position);
+
+  RingTopology* ring_topology;
+  int nodes_in_ring;
+  int root_index;
+  int position;
+  uint64_t block_size;
+  std::list<Step> steps;
+};
+
+} // namespace AstraSim
+
+#endif /* __ROOTED_COLLECTIVE_HH__ */
@@ -0,0 +1,268 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "astra-sim/system/scheduling/CollectiveAutotuner.hh"
+
+#include <cmath>
+#include <fstream>
+#include <iostream>
+
+using namespace std;
+using namespace AstraSim;
+using json = nlohmann::json;
+
+CollectiveAutotuner::CollectiveAutotuner(
+    string table_path,
+    vector<int> dim_size,
+    vector<double> dim_BW,
+    vector<string> dim_topology,
+    double link_latency) {
+  this->dim_size = dim_size;
+  this->link_latency = link_latency;
+  for (int i = 0; i < dim_size.size(); i++) {
+    // without bandwidth information only the relative cost matters
+    this->dim_BW.push_back(i < dim_BW.size() && dim_BW[i] > 0 ? dim_BW[i] : 1);
+    this->dim_topology.push_back(
+        i < dim_topology.size() ? dim_topology[i] : "Ring");
+  }
+  implementations["ring"] = new CollectiveImpl(CollectiveImplType::Ring);
+  implementations["direct"] =
+      new DirectCollectiveImpl(CollectiveImplType::Direct, -1);
+  implementations["halvingDoubling"] =
+      new CollectiveImpl(CollectiveImplType::HalvingDoubling);
+  if (!load_table(table_path)) {
+    build_table();
+    save_table(table_path);
+  }
+}
+
+CollectiveAutotuner::~CollectiveAutotuner() {
+  for (auto impl : implementations) {
+    delete impl.second;
+  }
+}
+
+string CollectiveAutotuner::get_comm_type_name(ComType comm_type) {
+  switch (comm_type) {
+    case ComType::All_Reduce:
+      return "all-reduce";
+    case ComType::Reduce_Scatter:
+      return "reduce-scatter";
+    case ComType::All_Gather:
+      return "all-gather";
+    case ComType::All_to_All:
+      return "all-to-all";
+    default:
+      return "";
+  }
+}
+
+CollectiveImpl* CollectiveAutotuner::get_implementation(
+    ComType comm_type,
+    int dim,
+    int nodes,
+    uint64_t size,
+    CollectiveImpl* configured_impl) {
+  if (configured_impl->type != CollectiveImplType::Ring &&
+      configured_impl->type != CollectiveImplType::Direct &&
+      configured_impl->type != CollectiveImplType::HalvingDoubling) {
+    return configured_impl;
+  }
+  auto table = tables.find(get_comm_type_name(comm_type));
+  // the table is per physical dimension; a group whose ring has another size
+  // keeps its configured algorithm
+  if (table == tables.end() || dim >= table->second.size() ||
+      dim >= dim_size.size() || dim_size[dim] != nodes ||
+      table->second[dim].size() == 0) {
+    return configured_impl;
+  }
+  for (auto& entry : table->second[dim]) {
+    if (size <= entry.max_size) {
+      return implementations[entry.implementation];
+    }
+  }
+  return implementations[table->second[dim].back().implementation];
+}
+
+void CollectiveAutotuner::build_table() {
+  vector<ComType> comm_types{
+      ComType::All_Reduce,
+      ComType::Reduce_Scatter,
+      ComType::All_Gather,
+      ComType::All_to_All};
+  for (auto comm_type : comm_types) {
+    vector<vector<TuningEntry>>& table = tables[get_comm_type_name(comm_type)];
+    for (int dim = 0; dim < dim_size.size(); dim++) {
+      int nodes = dim_size[dim];
+      vector<string> candidates{"ring", "direct"};
+      // halving-doubling needs a power of two number of NPUs and has no
+      // all-to-all
+      if ((nodes & (nodes - 1)) == 0 && comm_type != ComType::All_to_All) {
+        candidates.push_back("halvingDoubling");
+      }
+      vector<TuningEntry> entries;
+      // sweep from 1KB to 4GB
+      for (uint64_t size = 1024; size <= (1ULL << 32); size *= 4) {
+        string best;
+        double best_time = -1;
+        for (auto candidate : candidates) {
+          double time = estimate_time(
+              comm_type,
+              candidate,
+              dim_topology[dim],
+              nodes,
+              size,
+              dim_BW[dim]);
+          if (best_time < 0 || time < best_time) {
+            best_time = time;
+            best = candidate;
+          }
+        }
+        if (entries.size() > 0 && entries.back().implementation == best) {
+          entries.back().max_size = size;
+        } else {
+          entries.push_back(TuningEntry(size, best));
+        }
+      }
+      table.push_back(entries);
+    }
+  }
+}
+
+// Alpha-beta estimate (in ns) of one phase of the given collective on a
+// dimension of the given physical topology, with size in bytes and bw in
+// GB/s (bytes/ns).
+double CollectiveAutotuner::estimate_time(
+    ComType comm_type,
+    string implementation,
+    string topology,
+    int nodes,
+    double size,
+    double bw) {
+  double p = nodes;
+  double log_p = log2(p);
+  double steps = 0;
+  double bytes = 0;
+  switch (comm_type) {
+    case ComType::All_Reduce:
+      bytes = 2 * (p - 1) / p * size;
+      steps = implementation == "ring" ? 2 * (p - 1)
+          : implementation == "direct" ? 2 : 2 * log_p;
+      break;
+    case ComType::Reduce_Scatter:
+      bytes = (p - 1) / p * size;
+      steps = implementation == "ring" ? p - 1
+          : implementation == "direct" ? 1 : log_p;
+      break;
+    case ComType::All_Gather:
+      bytes = (p - 1) * size;
+      steps = implementation == "ring" ? p - 1
+          : implementation == "direct" ? 1 : log_p;
+      break;
+    case ComType::All_to_All:
+      // the ring all-to-all forwards the data of the far peers
+      bytes = implementation == "ring" ? (p - 1) / 2 * size
+                                       : (p - 1) / p * size;
+      steps = implementation == "ring" ? p - 1 : 1;
+      break;
+    default:;
+  }
+  if (topology == "FullyConnected") {
+    // a direct collective spreads its data on the p-1 links of the NPU
+    if (implementation == "direct") {
+      return steps * link_latency + bytes / ((p - 1) * bw);
+    }
+    return steps * link_latency + bytes / bw;
+  } else if (topology == "Switch") {
+    // every message crosses two links through the switch
+    return steps * 2 * link_latency + bytes / bw;
+  }
+  // bidirectional ring: a message to a peer at distance d crosses d links,
+  // and every NPU can inject on its two links
+  if (implementation == "ring") {
+    return steps * link_latency + bytes / bw;
+  } else if (implementation == "direct") {
+    return steps * (p / 4) * link_latency + bytes * (p / 4) / (2 * bw);
+  }
+  // halving-doubling: on average the distance of its steps is (p-1)/log p
+  double distance = log_p > 0 ? (p - 1) / log_p : 1;
+  return steps * distance * link_latency + bytes * distance / (2 * bw);
+}
+
+bool CollectiveAutotuner::load_table(string table_path) {
+  ifstream inFile;
+  inFile.open(table_path);
+  if (!inFile) {
+    return false;
+  }
+  json j;
+  inFile >> j;
+  inFile.close();
+  // the algorithms picked for another network would be wrong on this one
+  if (!j.contains("network") || j["network"] != get_network_signature()) {
+    cout << "collective autotuning table at " << table_path
+         << " was built for another network, rebuilding it" << endl;
+    return false;
+  }
+  for (auto& comm_table : j.items()) {
+    if (comm_table.key() == "network") {
+      continue;
+    }
+    vector<vector<TuningEntry>>& table = tables[comm_table.key()];
+    for (auto& dim_table : comm_table.value()) {
+      vector<TuningEntry> entries;
+      for (auto& entry : dim_table) {
+        string implementation = entry["implementation"];
+        if (implementations.find(implementation) == implementations.end()) {
+          Sys::sys_panic(
+              "unknown implementation in the autotuning table: " +
+              implementation);
+        }
+        entries.push_back(TuningEntry(entry["max-size"], implementation));
+      }
+      table.push_back(entries);
+    }
+  }
+  cout << "collective autotuning table loaded from " << table_path << endl;
+  return true;
+}
+
+// What the table depends on: the size, bandwidth and topology of every
+// dimension, and the link latency.
+json CollectiveAutotuner::get_network_signature() {
+  json signature;
+  signature["dims"] = dim_size;
+  signature["bandwidths"] = dim_BW;
+  signature["topology"] = dim_topology;
+  signature["link-latency"] = link_latency;
+  return signature;
+}
+
+void CollectiveAutotuner::save_table(string table_path) {
+  json j;
+  j["network"] = get_network_signature();
+  for (auto& table : tables) {
+    json comm_table = json::array();
+    for (auto& entries : table.second) {
+      json dim_table = json::array();
+      for (auto& entry : entries) {
+        dim_table.push_back(
+            {{"max-size", entry.max_size},
+             {"implementation", entry.implementation}});
+      }
+      comm_table.push_back(dim_table);
+    }
+    j[table.first] = comm_table;
+  }
+  ofstream outFile;
+  outFile.open(table_path);
+  if (!outFile) {
+    cerr << "Unable to write the autotuning table at: " << table_path << endl;
+    return;
+  }
+  outFile << j.dump(2) << endl;
+  outFile.close();
+  cout << "collective autotuning table saved at " << table_path << endl;
+}
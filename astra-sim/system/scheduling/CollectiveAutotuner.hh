@@ -0,0 +1,76 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#ifndef __COLLECTIVE_AUTOTUNER_HH__
+#define __COLLECTIVE_AUTOTUNER_HH__
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "astra-sim/json.hpp"
+#include "astra-sim/system/Common.hh"
+#include "astra-sim/system/Sys.hh"
+
+namespace AstraSim {
+
+class TuningEntry {
+ public:
+  TuningEntry(uint64_t max_size, std::string implementation) {
+    this->max_size = max_size;
+    this->implementation = implementation;
+  }
+
+  uint64_t max_size;
+  std::string implementation;
+};
+
+// Picks the collective algorithm of every phase from its chunk size, using a
+// size -> algorithm table per collective and dimension. The table is loaded
+// from disk, or built with an alpha-beta model of every candidate over a
+// sweep of sizes and saved for the next runs. Only the algorithms that run
+// on the same logical ring (ring, direct, halvingDoubling) are swapped. The
+// file records the network the table was built for, and a table of another
+// network is rebuilt. One autotuner is shared by all the NPUs (see
+// SystemConfig::get_collective_autotuner).
+class CollectiveAutotuner {
+ public:
+  CollectiveAutotuner(
+      std::string table_path,
+      std::vector<int> dim_size,
+      std::vector<double> dim_BW,
+      std::vector<std::string> dim_topology,
+      double link_latency);
+  ~CollectiveAutotuner();
+  CollectiveImpl* get_implementation(
+      ComType comm_type,
+      int dim,
+      int nodes,
+      uint64_t size,
+      CollectiveImpl* configured_impl);
+  void build_table();
+  bool load_table(std::string table_path);
+  void save_table(std::string table_path);
+  nlohmann::json get_network_signature();
+  double estimate_time(
+      ComType comm_type,
+      std::string implementation,
+      std::string topology,
+      int nodes,
+      double size,
+      double bw);
+  static std::string get_comm_type_name(ComType comm_type);
+
+  std::vector<int> dim_size;
+  std::vector<double> dim_BW;
+  std::vector<std::string> dim_topology;
+  double link_latency;
+  std::map<std::string, std::vector<std::vector<TuningEntry>>> tables;
+  std::map<std::string, CollectiveImpl*> implementations;
+};
+
+} // namespace AstraSim
+
+#endif /* __COLLECTIVE_AUTOTUNER_HH__ */
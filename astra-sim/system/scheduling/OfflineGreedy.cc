@@ -22,24 +22,14 @@ DimElapsedTime::DimElapsedTime(int dim_num) {
 }
 OfflineGreedy::OfflineGreedy(Sys* sys) {
   this->sys = sys;
-  if (sys->dim_to_break == -1) {
-    this->dim_size = sys->physical_dims;
-    this->dim_BW.resize(this->dim_size.size());
-    for (int i = 0; i < this->dim_size.size(); i++) {
-      this->dim_BW[i] = sys->comm_NI->get_BW_at_dimension(i);
-      this->dim_elapsed_time.push_back(DimElapsedTime(i));
-    }
-  } else {
-    this->dim_size = sys->logical_broken_dims;
-    this->dim_BW.resize(this->dim_size.size());
-    for (int i = 0; i < this->dim_size.size(); i++) {
-      if (i > sys->dim_to_break) {
-        this->dim_BW[i] = sys->comm_NI->get_BW_at_dimension(i - 1);
-      } else {
-        this->dim_BW[i] = sys->comm_NI->get_BW_at_dimension(i);
-      }
-      this->dim_elapsed_time.push_back(DimElapsedTime(i));
-    }
+  // one entry per logical dimension, with the bandwidth of its physical
+  // dimension
+  this->dim_size = sys->logical_dims;
+  this->dim_BW.resize(this->dim_size.size());
+  for (int i = 0; i < this->dim_size.size(); i++) {
+    this->dim_BW[i] =
+        sys->comm_NI->get_BW_at_dimension(sys->logical_to_physical_dim[i]);
+    this->dim_elapsed_time.push_back(DimElapsedTime(i));
   }
   if (sys->id == 0) {
     std::cout << "Themis is configured with the following parameters: "
@@ -85,7 +75,7 @@ std::vector<int> OfflineGreedy::get_chunk_scheduling(
     long long chunk_id,
     uint64_t& remaining_data_size,
     uint64_t recommended_chunk_size,
-    std::vector<bool>& dimensions_involved,
+    const std::vector<bool>& dimensions_involved,
     InterDimensionScheduling inter_dim_scheduling,
     ComType comm_type) {
   if (chunk_schedule.find(chunk_id) != chunk_schedule.end()) {
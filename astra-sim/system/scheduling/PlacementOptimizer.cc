@@ -0,0 +1,243 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "astra-sim/system/scheduling/PlacementOptimizer.hh"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+
+#include "astra-sim/json.hpp"
+#include "astra-sim/system/SystemConfig.hh"
+
+using namespace std;
+using namespace AstraSim;
+using json = nlohmann::json;
+
+PlacementOptimizer::PlacementOptimizer(Sys* sys, string output_path) {
+  this->sys = sys;
+  this->output_path = output_path;
+  this->group_sizes = sys->system_config->parallel_group_sizes;
+  if (group_sizes.size() == 0) {
+    Sys::sys_panic("placement-search-output needs parallel-group-sizes");
+  }
+  int npus = 1;
+  for (int size : group_sizes) {
+    npus *= size;
+  }
+  if (sys->total_nodes % npus != 0) {
+    Sys::sys_panic("the parallel groups do not divide the network");
+  }
+  // the outermost (data parallel) group takes the remaining NPUs
+  group_sizes.push_back(sys->total_nodes / npus);
+  for (int i = 0; i < sys->physical_dims.size(); i++) {
+    double bw = sys->comm_NI->get_BW_at_dimension(i);
+    // without bandwidth information only the relative cost matters
+    dim_BW.push_back(bw > 0 ? bw : 1);
+  }
+}
+
+void PlacementOptimizer::add_collective(
+    int group_id,
+    ComType comm_type,
+    uint64_t size) {
+  volumes[make_pair(group_id, comm_type)] += size;
+}
+
+bool PlacementOptimizer::get_group_dimensions(
+    const vector<int>& order,
+    vector<vector<pair<int, double>>>& group_dimensions) {
+  vector<int> boundaries;
+  int npus = 1;
+  for (int group : order) {
+    npus *= group_sizes[group];
+    boundaries.push_back(npus);
+  }
+  DimensionFactorization factorization;
+  string error;
+  if (!SystemConfig::factorize_dimensions(
+          sys->physical_dims, boundaries, factorization, error)) {
+    return false;
+  }
+  group_dimensions.assign(group_sizes.size(), vector<pair<int, double>>());
+  int position = 0;
+  int npus_below = 1;
+  for (int dim = 0; dim < factorization.logical_dims.size(); dim++) {
+    while (position < order.size() && boundaries[position] <= npus_below) {
+      position++;
+    }
+    if (factorization.logical_dims[dim] > 1) {
+      group_dimensions[order[position]].push_back(make_pair(
+          factorization.logical_dims[dim],
+          dim_BW[factorization.physical_dim[dim]]));
+    }
+    npus_below *= factorization.logical_dims[dim];
+  }
+  return true;
+}
+
+// The communication time of the recorded collectives when the groups have
+// the given dimensions.
+double PlacementOptimizer::get_communication_time(
+    const vector<vector<pair<int, double>>>& group_dimensions) {
+  double time = 0;
+  for (auto& volume : volumes) {
+    int group = volume.first.first - 1;
+    // collectives of all the NPUs cost the same in every placement
+    if (group < 0 || group >= group_sizes.size()) {
+      continue;
+    }
+    time += Sys::estimate_hierarchical_time(
+        group_dimensions[group], volume.first.second, volume.second);
+  }
+  return time;
+}
+
+// The order of the groups (innermost first) the workload ran with, read from
+// the instances NPU 0 belongs to. In a nested placement (the layout
+// save_placement writes), the instance of a group that holds NPU 0 is
+// 0, s, 2s, ... where s is the product of the sizes of the groups inside
+// it. False, with the reason in error, if a group is missing or is laid out
+// otherwise.
+bool PlacementOptimizer::get_run_order(
+    const map<int, CommunicatorGroup*>& comm_groups,
+    vector<int>& order,
+    string& error) {
+  vector<pair<int, int>> strides;
+  order.clear();
+  for (int group = 0; group < group_sizes.size(); group++) {
+    // groups of a single NPU fit anywhere
+    if (group_sizes[group] == 1) {
+      order.push_back(group);
+      continue;
+    }
+    auto it = comm_groups.find(group + 1);
+    if (it == comm_groups.end()) {
+      error = "group " + to_string(group + 1) +
+          " is not in the communicator group file";
+      return false;
+    }
+    vector<int> NPUs = it->second->involved_NPUs;
+    sort(NPUs.begin(), NPUs.end());
+    if (NPUs.size() != group_sizes[group]) {
+      error = "group " + to_string(group + 1) + " has " +
+          to_string(NPUs.size()) + " NPUs instead of " +
+          to_string(group_sizes[group]);
+      return false;
+    }
+    int stride = NPUs[1] - NPUs[0];
+    for (int member = 0; member < NPUs.size(); member++) {
+      if (NPUs[member] != member * stride) {
+        error = "group " + to_string(group + 1) +
+            " is not a strided set of NPUs starting at NPU 0";
+        return false;
+      }
+    }
+    strides.push_back(make_pair(stride, group));
+  }
+  sort(strides.begin(), strides.end());
+  int npus_below = 1;
+  for (auto& stride : strides) {
+    if (stride.first != npus_below) {
+      error = "the groups are not nested";
+      return false;
+    }
+    order.push_back(stride.second);
+    npus_below *= group_sizes[stride.second];
+  }
+  return true;
+}
+
+void PlacementOptimizer::search(
+    Tick iteration_time,
+    const map<int, CommunicatorGroup*>& comm_groups) {
+  // the simulated iteration time only tells the cost of the placement the
+  // workload ran with; without it no iteration time can be predicted
+  double current_cost = -1;
+  vector<int> run_order;
+  string error;
+  if (get_run_order(comm_groups, run_order, error)) {
+    vector<vector<pair<int, double>>> group_dimensions;
+    if (get_group_dimensions(run_order, group_dimensions)) {
+      current_cost = get_communication_time(group_dimensions);
+    } else {
+      error = "the groups of the run do not fit the network";
+    }
+  }
+  if (current_cost < 0) {
+    cout << "placement search: the placement of the run is unknown (" << error
+         << "), the iteration times are not predicted" << endl;
+  }
+  vector<int> order(group_sizes.size());
+  iota(order.begin(), order.end(), 0);
+  double best_cost = -1;
+  vector<int> best_order;
+  cout << "placement search (group: NPUs, innermost first):" << endl;
+  do {
+    vector<vector<pair<int, double>>> group_dimensions;
+    if (!get_group_dimensions(order, group_dimensions)) {
+      continue;
+    }
+    double cost = get_communication_time(group_dimensions);
+    cout << "  ";
+    for (int group : order) {
+      cout << group + 1 << ":" << group_sizes[group] << " ";
+    }
+    cout << "communication: " << cost << " ns";
+    if (current_cost >= 0) {
+      cout << ", predicted iteration time: "
+           << iteration_time - current_cost + cost << " ns";
+    }
+    if (order == run_order) {
+      cout << " (current)";
+    }
+    cout << endl;
+    if (best_cost < 0 || cost < best_cost) {
+      best_cost = cost;
+      best_order = order;
+    }
+  } while (next_permutation(order.begin(), order.end()));
+  if (best_order.empty()) {
+    cout << "no placement of the parallel groups fits the network" << endl;
+    return;
+  }
+  save_placement(best_order);
+  cout << "best placement saved to " << output_path;
+  if (current_cost >= 0) {
+    cout << ", predicted iteration time: "
+         << iteration_time - current_cost + best_cost << " ns";
+  }
+  cout << endl;
+}
+
+// Writes the communicator group file of a placement: for every group id, the
+// NPUs of each of its instances.
+void PlacementOptimizer::save_placement(const vector<int>& order) {
+  json j;
+  int stride = 1;
+  for (int group : order) {
+    int size = group_sizes[group];
+    vector<vector<int>> instances;
+    for (int npu = 0; npu < sys->total_nodes; npu++) {
+      if ((npu / stride) % size != 0) {
+        continue;
+      }
+      vector<int> members;
+      for (int member = 0; member < size; member++) {
+        members.push_back(npu + member * stride);
+      }
+      instances.push_back(members);
+    }
+    j[to_string(group + 1)] = instances;
+    stride *= size;
+  }
+  ofstream outFile(output_path);
+  if (!outFile) {
+    cerr << "Unable to write the placement to: " << output_path << endl;
+    return;
+  }
+  outFile << j.dump(2) << endl;
+}
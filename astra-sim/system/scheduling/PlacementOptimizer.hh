@@ -0,0 +1,57 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#ifndef __PLACEMENT_OPTIMIZER_HH__
+#define __PLACEMENT_OPTIMIZER_HH__
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "astra-sim/system/Common.hh"
+#include "astra-sim/system/Sys.hh"
+
+namespace AstraSim {
+
+// Searches the placement of the parallel groups (parallel-group-sizes, plus
+// the group that completes the network) on the NPUs. Communicator group i
+// of the workload is the i-th parallel group. While the workload runs, NPU
+// 0 records the bytes every group moves per collective type; at the end
+// every order of the groups over the dimensions (innermost first) is costed
+// with a bandwidth model of hierarchical collectives, and the best one is
+// written as a communicator group file. The iteration time of every order
+// is predicted from the simulated one and the cost of the order the
+// workload ran with, which is read from its communicator groups.
+class PlacementOptimizer {
+ public:
+  PlacementOptimizer(Sys* sys, std::string output_path);
+  void add_collective(int group_id, ComType comm_type, uint64_t size);
+  void search(
+      Tick iteration_time,
+      const std::map<int, CommunicatorGroup*>& comm_groups);
+  bool get_run_order(
+      const std::map<int, CommunicatorGroup*>& comm_groups,
+      std::vector<int>& order,
+      std::string& error);
+  // the (size, bandwidth) of the logical dimensions of every group; false
+  // if the groups do not fit the network in this order
+  bool get_group_dimensions(
+      const std::vector<int>& order,
+      std::vector<std::vector<std::pair<int, double>>>& group_dimensions);
+  double get_communication_time(
+      const std::vector<std::vector<std::pair<int, double>>>& group_dimensions);
+  void save_placement(const std::vector<int>& order);
+
+  Sys* sys;
+  std::string output_path;
+  std::vector<int> group_sizes;
+  std::vector<double> dim_BW;
+  std::map<std::pair<int, ComType>, uint64_t> volumes;
+};
+
+} // namespace AstraSim
+
+#endif /* __PLACEMENT_OPTIMIZER_HH__ */
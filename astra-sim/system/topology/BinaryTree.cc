@@ -11,12 +11,26 @@ using namespace std;
 using namespace AstraSim;
 
 BinaryTree::BinaryTree(
-    int id, TreeType tree_type, int total_tree_nodes, int start, int stride)
+    TreeType tree_type, int total_tree_nodes, int start, int stride)
     : BasicLogicalTopology(BasicLogicalTopology::BasicTopology::BinaryTree) {
   this->total_tree_nodes = total_tree_nodes;
   this->start = start;
   this->tree_type = tree_type;
   this->stride = stride;
+  initialize();
+}
+
+BinaryTree::BinaryTree(TreeType tree_type, const vector<int>& NPUs)
+    : BasicLogicalTopology(BasicLogicalTopology::BasicTopology::BinaryTree) {
+  this->total_tree_nodes = NPUs.size();
+  this->start = 0;
+  this->tree_type = tree_type;
+  this->stride = 1;
+  this->ordered_ids = NPUs;
+  initialize();
+}
+
+void BinaryTree::initialize() {
   tree = new Node(-1, nullptr, nullptr, nullptr);
   int depth = 1;
   int tmp = total_tree_nodes;
@@ -51,8 +65,12 @@ void BinaryTree::build_tree(Node* node) {
   if (node->left_child != nullptr) {
     build_tree(node->left_child);
   }
-  node->id = start;
-  node_list[start] = node;
+  if (ordered_ids.empty()) {
+    node->id = start;
+  } else {
+    node->id = ordered_ids[start];
+  }
+  node_list[node->id] = node;
   start += stride;
   if (node->right_child != nullptr) {
     build_tree(node->right_child);
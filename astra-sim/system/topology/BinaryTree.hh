@@ -7,6 +7,7 @@ LICENSE file in the root directory of this source tree.
 #define __BINARY_TREE_HH__
 
 #include <map>
+#include <vector>
 
 #include "astra-sim/system/topology/BasicLogicalTopology.hh"
 #include "astra-sim/system/topology/Node.hh"
@@ -20,17 +21,20 @@ class BinaryTree : public BasicLogicalTopology {
   enum class Type { Leaf, Root, Intermediate };
 
   BinaryTree(
-      int id,
       TreeType tree_type,
       int total_tree_nodes,
       int start,
       int stride);
+  // a tree over an arbitrary set of NPUs, placed in the order of the list
+  // (the in-order traversal of the tree visits them in that order)
+  BinaryTree(TreeType tree_type, const std::vector<int>& NPUs);
   virtual ~BinaryTree();
 
   int get_num_of_nodes_in_dimension(int dimension) override {
     return total_tree_nodes;
   }
 
+  void initialize();
   Node* initialize_tree(int depth, Node* parent);
   void build_tree(Node* node);
   int get_parent_id(int id);
@@ -43,6 +47,7 @@ class BinaryTree : public BasicLogicalTopology {
   int start;
   TreeType tree_type;
   int stride;
+  std::vector<int> ordered_ids;
   Node* tree;
   std::map<int, Node*> node_list;
 };
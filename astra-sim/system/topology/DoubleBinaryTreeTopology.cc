@@ -5,20 +5,30 @@ LICENSE file in the root directory of this source tree.
 
 #include "astra-sim/system/topology/DoubleBinaryTreeTopology.hh"
 
+#include "astra-sim/system/topology/TopologyRegistry.hh"
+
 using namespace AstraSim;
 
 DoubleBinaryTreeTopology::DoubleBinaryTreeTopology(
     int id, int total_tree_nodes, int start, int stride) {
-  DBMAX = new BinaryTree(
-      id, BinaryTree::TreeType::RootMax, total_tree_nodes, start, stride);
-  DBMIN = new BinaryTree(
-      id, BinaryTree::TreeType::RootMin, total_tree_nodes, start, stride);
+  DBMAX = TopologyRegistry::get_binary_tree(
+      BinaryTree::TreeType::RootMax, total_tree_nodes, start, stride);
+  DBMIN = TopologyRegistry::get_binary_tree(
+      BinaryTree::TreeType::RootMin, total_tree_nodes, start, stride);
+  this->counter = 0;
+}
+
+DoubleBinaryTreeTopology::DoubleBinaryTreeTopology(
+    int id, const std::vector<int>& NPUs) {
+  DBMAX = TopologyRegistry::get_binary_tree(
+      BinaryTree::TreeType::RootMax, NPUs);
+  DBMIN = TopologyRegistry::get_binary_tree(
+      BinaryTree::TreeType::RootMin, NPUs);
   this->counter = 0;
 }
 
+// the trees are shared through the TopologyRegistry, which owns them
 DoubleBinaryTreeTopology::~DoubleBinaryTreeTopology() {
-  delete DBMIN;
-  delete DBMAX;
 }
 
 LogicalTopology* DoubleBinaryTreeTopology::get_topology() {
@@ -6,14 +6,15 @@ LICENSE file in the root directory of this source tree.
 #ifndef __DOUBLE_BINARY_TREE_TOPOLOGY_HH__
 #define __DOUBLE_BINARY_TREE_TOPOLOGY_HH__
 
+#include "astra-sim/system/topology/BinaryTree.hh"
 #include "astra-sim/system/topology/ComplexLogicalTopology.hh"
-#include "astra-sim/system/topology/LocalRingGlobalBinaryTree.hh"
 
 namespace AstraSim {
 
 class DoubleBinaryTreeTopology : public ComplexLogicalTopology {
  public:
   DoubleBinaryTreeTopology(int id, int total_tree_nodes, int start, int stride);
+  DoubleBinaryTreeTopology(int id, const std::vector<int>& NPUs);
   ~DoubleBinaryTreeTopology();
   LogicalTopology* get_topology() override;
   BasicLogicalTopology* get_basic_topology_at_dimension(
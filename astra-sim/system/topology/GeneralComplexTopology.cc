@@ -24,10 +24,18 @@ GeneralComplexTopology::GeneralComplexTopology(
   for (int dim = 0; dim < collective_impl.size(); dim++) {
     if (collective_impl[dim]->type ==
             CollectiveImplType::Ring ||
+        collective_impl[dim]->type ==
+            CollectiveImplType::MultiChannelRing ||
         collective_impl[dim]->type ==
             CollectiveImplType::Direct ||
         collective_impl[dim]->type ==
-            CollectiveImplType::HalvingDoubling) {
+            CollectiveImplType::HalvingDoubling ||
+        collective_impl[dim]->type ==
+            CollectiveImplType::Chain ||
+        collective_impl[dim]->type ==
+            CollectiveImplType::BinomialTree ||
+        collective_impl[dim]->type ==
+            CollectiveImplType::InNetwork) {
       RingTopology* ring = new RingTopology(
           RingTopology::Dimension::NA,
           id,
@@ -50,6 +58,38 @@ GeneralComplexTopology::GeneralComplexTopology(
           RingTopology::Dimension::NA, id, total_npus, id % total_npus, 1);
       dimension_topology.push_back(ring);
       return;
+    } else if (
+        collective_impl[dim]->type == CollectiveImplType::OneRingSnake) {
+      RingTopology* ring = new RingTopology(
+          RingTopology::Dimension::NA, id, get_snake_order(dimension_size));
+      dimension_topology.push_back(ring);
+      return;
+    } else if (
+        collective_impl[dim]->type ==
+        CollectiveImplType::HierarchicalDirect) {
+      // the first group spans the fast dimension, the second one flattens all
+      // the remaining (slower) dimensions into one group of NPUs that share the
+      // same index in the fast dimension
+      RingTopology* local_ring = new RingTopology(
+          RingTopology::Dimension::NA,
+          id,
+          dimension_size[dim],
+          (id % (offset * dimension_size[dim])) / offset,
+          offset);
+      dimension_topology.push_back(local_ring);
+      int global_offset = offset * dimension_size[dim];
+      int global_npus = 1;
+      for (int d = dim + 1; d < dimension_size.size(); d++) {
+        global_npus *= dimension_size[d];
+      }
+      RingTopology* global_ring = new RingTopology(
+          RingTopology::Dimension::NA,
+          id,
+          global_npus,
+          (id % (global_offset * global_npus)) / global_offset,
+          global_offset);
+      dimension_topology.push_back(global_ring);
+      return;
     } else if (
         collective_impl[dim]->type ==
         CollectiveImplType::DoubleBinaryTree) {
@@ -70,6 +110,35 @@ GeneralComplexTopology::GeneralComplexTopology(
   }
 }
 
+// Boustrophedon order of all the NPUs: the fastest dimension is walked back
+// and forth while the slower ones advance by one, so consecutive NPUs differ
+// by one step in a single dimension (a reflected mixed-radix Gray code).
+// When the slowest dimension has an even size the last NPU is also a
+// wraparound neighbor of the first one.
+vector<int> GeneralComplexTopology::get_snake_order(
+    const vector<int>& dimension_size) {
+  vector<int> order(1, 0);
+  int offset = 1;
+  for (int dim = 0; dim < dimension_size.size(); dim++) {
+    vector<int> next_order;
+    next_order.reserve(order.size() * dimension_size[dim]);
+    for (int coordinate = 0; coordinate < dimension_size[dim]; coordinate++) {
+      if (coordinate % 2 == 0) {
+        for (auto it = order.begin(); it != order.end(); ++it) {
+          next_order.push_back(*it + coordinate * offset);
+        }
+      } else {
+        for (auto it = order.rbegin(); it != order.rend(); ++it) {
+          next_order.push_back(*it + coordinate * offset);
+        }
+      }
+    }
+    order.swap(next_order);
+    offset *= dimension_size[dim];
+  }
+  return order;
+}
+
 GeneralComplexTopology::~GeneralComplexTopology() {
   for (int i = 0; i < dimension_topology.size(); i++) {
     delete dimension_topology[i];
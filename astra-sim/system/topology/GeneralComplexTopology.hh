@@ -24,6 +24,8 @@ class GeneralComplexTopology : public ComplexLogicalTopology {
   int get_num_of_nodes_in_dimension(int dimension) override;
   BasicLogicalTopology* get_basic_topology_at_dimension(
       int dimension, ComType type) override;
+  static std::vector<int> get_snake_order(
+      const std::vector<int>& dimension_size);
 
   std::vector<LogicalTopology*> dimension_topology;
 };
@@ -0,0 +1,49 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "astra-sim/system/topology/GraphTopology.hh"
+
+using namespace std;
+using namespace AstraSim;
+
+GraphTopology::GraphTopology(
+    int id,
+    TopologyGraph* graph,
+    CollectiveImpl* collective_impl) {
+  ring = new RingTopology(RingTopology::Dimension::NA, id, graph->ring_order);
+  trees = nullptr;
+  if (collective_impl->type == CollectiveImplType::DoubleBinaryTree) {
+    trees = new DoubleBinaryTreeTopology(id, graph->ring_order);
+  }
+}
+
+GraphTopology::~GraphTopology() {
+  delete ring;
+  if (trees != nullptr) {
+    delete trees;
+  }
+}
+
+int GraphTopology::get_num_of_dimensions() {
+  return 1;
+}
+
+int GraphTopology::get_num_of_nodes_in_dimension(int dimension) {
+  if (dimension == 0) {
+    return ring->get_num_of_nodes_in_dimension(0);
+  }
+  return -1;
+}
+
+BasicLogicalTopology* GraphTopology::get_basic_topology_at_dimension(
+    int dimension, ComType type) {
+  if (dimension != 0) {
+    return nullptr;
+  }
+  if (trees != nullptr && type == ComType::All_Reduce) {
+    return trees->get_basic_topology_at_dimension(0, type);
+  }
+  return ring;
+}
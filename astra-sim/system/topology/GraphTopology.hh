@@ -0,0 +1,36 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#ifndef __GRAPH_TOPOLOGY_HH__
+#define __GRAPH_TOPOLOGY_HH__
+
+#include "astra-sim/system/topology/ComplexLogicalTopology.hh"
+#include "astra-sim/system/topology/DoubleBinaryTreeTopology.hh"
+#include "astra-sim/system/topology/RingTopology.hh"
+#include "astra-sim/system/topology/TopologyGraph.hh"
+
+namespace AstraSim {
+
+// One logical dimension spanning all the NPUs of a graph-defined network.
+// Ring, direct and halving-doubling collectives run on a ring that follows
+// the ring order of the graph; doubleBinaryTree all-reduces run on two trees
+// over the same order.
+class GraphTopology : public ComplexLogicalTopology {
+ public:
+  GraphTopology(int id, TopologyGraph* graph, CollectiveImpl* collective_impl);
+  ~GraphTopology();
+
+  int get_num_of_dimensions() override;
+  int get_num_of_nodes_in_dimension(int dimension) override;
+  BasicLogicalTopology* get_basic_topology_at_dimension(
+      int dimension, ComType type) override;
+
+  RingTopology* ring;
+  DoubleBinaryTreeTopology* trees;
+};
+
+} // namespace AstraSim
+
+#endif /* __GRAPH_TOPOLOGY_HH__ */
@@ -10,14 +10,13 @@ using namespace AstraSim;
 LocalRingGlobalBinaryTree::LocalRingGlobalBinaryTree(
     int id,
     int local_dim,
-    BinaryTree::TreeType tree_type,
     int total_tree_nodes,
     int start,
     int stride) {
   this->local_dimension = new RingTopology(
       RingTopology::Dimension::Local, id, local_dim, id % local_dim, 1);
   this->global_dimension_all_reduce =
-      new BinaryTree(id, tree_type, total_tree_nodes, start, stride);
+      new DoubleBinaryTreeTopology(id, total_tree_nodes, start, stride);
   this->global_dimension_other = new RingTopology(
       RingTopology::Dimension::Horizontal,
       id,
@@ -27,8 +26,8 @@ LocalRingGlobalBinaryTree::LocalRingGlobalBinaryTree(
 }
 
 LocalRingGlobalBinaryTree::~LocalRingGlobalBinaryTree() {
-  delete local_dimension;
   delete global_dimension_all_reduce;
+  delete local_dimension;
   delete global_dimension_other;
 }
 
@@ -56,7 +55,8 @@ BasicLogicalTopology* LocalRingGlobalBinaryTree::
     return nullptr;
   } else if (dimension == 2) {
     if (type == ComType::All_Reduce) {
-      return global_dimension_all_reduce;
+      return global_dimension_all_reduce->get_basic_topology_at_dimension(
+          0, type);
     }
     return global_dimension_other;
   } else {
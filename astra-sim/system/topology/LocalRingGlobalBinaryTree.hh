@@ -6,8 +6,8 @@ LICENSE file in the root directory of this source tree.
 #ifndef __LOCAL_RING_GLOBAL_BINARY_TREE_HH__
 #define __LOCAL_RING_GLOBAL_BINARY_TREE_HH__
 
-#include "astra-sim/system/topology/BinaryTree.hh"
 #include "astra-sim/system/topology/ComplexLogicalTopology.hh"
+#include "astra-sim/system/topology/DoubleBinaryTreeTopology.hh"
 #include "astra-sim/system/topology/RingTopology.hh"
 
 namespace AstraSim {
@@ -17,7 +17,6 @@ class LocalRingGlobalBinaryTree : public ComplexLogicalTopology {
   LocalRingGlobalBinaryTree(
       int id,
       int local_dim,
-      BinaryTree::TreeType tree_type,
       int total_tree_nodes,
       int start,
       int stride);
@@ -30,7 +29,7 @@ class LocalRingGlobalBinaryTree : public ComplexLogicalTopology {
 
   RingTopology* local_dimension;
   RingTopology* global_dimension_other;
-  BinaryTree* global_dimension_all_reduce;
+  DoubleBinaryTreeTopology* global_dimension_all_reduce;
 };
 
 } // namespace AstraSim
@@ -63,7 +63,7 @@ BasicLogicalTopology* LocalRingNodeA2AGlobalDBT ::
   } else if (dimension == 2) {
     if (type == ComType::All_Reduce) {
       return global_dimension_all_reduce->get_basic_topology_at_dimension(
-          2, type);
+          0, type);
     } else {
       return global_dimension_other;
     }
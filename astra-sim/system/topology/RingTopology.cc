@@ -8,9 +8,18 @@ LICENSE file in the root directory of this source tree.
 #include <cassert>
 #include <iostream>
 
+#include "astra-sim/system/topology/TopologyRegistry.hh"
+
 using namespace std;
 using namespace AstraSim;
 
+RingNodeTable::RingNodeTable(const std::vector<int>& NPUs) {
+  this->nodes = NPUs;
+  for (int i = 0; i < NPUs.size(); i++) {
+    id_to_index[NPUs[i]] = i;
+  }
+}
+
 RingTopology::RingTopology(
     Dimension dimension,
     int id,
@@ -26,14 +35,9 @@ RingTopology::RingTopology(
   this->total_nodes_in_ring = NPUs.size();
   this->dimension=dimension;
   this->offset=-1;
-  this->index_in_ring=-1;
-  for(int i=0;i<total_nodes_in_ring;i++){
-    id_to_index[NPUs[i]]=i;
-    index_to_id[i]=NPUs[i];
-    if(id==NPUs[i]){
-      index_in_ring=i;
-    }
-  }
+  this->first_node=-1;
+  this->node_table = TopologyRegistry::get_ring_node_table(NPUs);
+  this->index_in_ring = get_index_of(id);
 
     cout << "custom ring, "
     << "id: " << id << " dimension: " << name
@@ -70,94 +74,43 @@ RingTopology::RingTopology(
   this->dimension = dimension;
   this->offset=offset;
 
-  id_to_index[id] = index_in_ring;
-  index_to_id[index_in_ring]=id;
-  int tmp=id;
-  for(int i=0;i<total_nodes_in_ring-1;i++){
-    tmp = get_receiver_homogeneous(tmp,RingTopology::Direction::Clockwise, offset);
-  }
-}
-
-int RingTopology::get_receiver_homogeneous(int node_id, Direction direction, int offset) {
-  assert(id_to_index.find(node_id) != id_to_index.end());
-  int index = id_to_index[node_id];
-  if (direction == RingTopology::Direction::Clockwise) {
-    int receiver = node_id + offset;
-    if (index == total_nodes_in_ring - 1) {
-      receiver -= (total_nodes_in_ring * offset);
-      index = 0;
-    } else {
-      index++;
-    }
-    if (receiver < 0) {
-      cout << "at dim: " << name << "at id: " << id
-      << "dimension: " << name << " index: " << index
-      << " ,node id: " << node_id << " ,offset: " << offset
-      << " ,index_in_ring: " << index_in_ring
-      << " receiver: " << receiver << endl;
-    }
-    assert(receiver >= 0);
-    id_to_index[receiver] = index;
-    index_to_id[index] = receiver;
-    return receiver;
-  } else {
-    int receiver = node_id - offset;
-    if (index == 0) {
-      receiver += (total_nodes_in_ring * offset);
-      index = total_nodes_in_ring - 1;
-    } else {
-      index--;
-    }
-    if (receiver < 0) {
-      cout << "at dim: " << name << "at id: " << id
-      << "dimension: " << name << " index: " << index
-      << " ,node id: " << node_id << " ,offset: " << offset
-      << " ,index_in_ring: " << index_in_ring
-      << " receiver: " << receiver << endl;
-    }
-    assert(receiver >= 0);
-    id_to_index[receiver] = index;
-    index_to_id[index] = receiver;
-    return receiver;
-  }
+  this->first_node = id - index_in_ring * offset;
+  this->node_table = nullptr;
 }
 
 int RingTopology::get_receiver(int node_id, Direction direction) {
-  assert(id_to_index.find(node_id) != id_to_index.end());
-  int index = id_to_index[node_id];
+  int index = get_index_of(node_id);
+  assert(index >= 0);
   if (direction == RingTopology::Direction::Clockwise) {
-    index++;
-    if(index==total_nodes_in_ring){
-      index=0;
-    }
-    return index_to_id[index];
-  }
-  else{
-    index--;
-    if(index<0){
-      index=total_nodes_in_ring-1;
-    }
-    return index_to_id[index];
+    index = index == total_nodes_in_ring - 1 ? 0 : index + 1;
+  } else {
+    index = index == 0 ? total_nodes_in_ring - 1 : index - 1;
   }
+  return get_node_id_at_index(index);
 }
 
 int RingTopology::get_sender(int node_id, Direction direction) {
-  assert(id_to_index.find(node_id) != id_to_index.end());
-  int index = id_to_index[node_id];
+  int index = get_index_of(node_id);
+  assert(index >= 0);
   if (direction == RingTopology::Direction::Anticlockwise) {
-    index++;
-    if(index==total_nodes_in_ring){
-      index=0;
-    }
-    return index_to_id[index];
+    index = index == total_nodes_in_ring - 1 ? 0 : index + 1;
+  } else {
+    index = index == 0 ? total_nodes_in_ring - 1 : index - 1;
   }
-  else{
-    index--;
-    if(index<0){
-      index=total_nodes_in_ring-1;
-    }
-    return index_to_id[index];
+  return get_node_id_at_index(index);
+}
+
+// The NPUs at distance 1 to n-1 from node_id in the direction, nearest first.
+// Collectives that walk the ring step by step look their peers up here once
+// instead of resolving the ring on every step.
+std::vector<int> RingTopology::get_peers(int node_id, Direction direction) {
+  std::vector<int> peers;
+  int peer = node_id;
+  for (int i = 1; i < total_nodes_in_ring; i++) {
+    peer = get_receiver(peer, direction);
+    peers.push_back(peer);
   }
+  return peers;
 }
 
 int RingTopology::get_index_in_ring() {
@@ -15,6 +15,16 @@ LICENSE file in the root directory of this source tree.
 
 namespace AstraSim {
 
+// NPU id of every index of a custom ring, shared by all the NPUs of the ring
+// through the TopologyRegistry.
+class RingNodeTable {
+ public:
+  RingNodeTable(const std::vector<int>& NPUs);
+
+  std::vector<int> nodes;
+  std::unordered_map<int, int> id_to_index;
+};
+
 class RingTopology : public BasicLogicalTopology {
  public:
   enum class Direction { Clockwise, Anticlockwise };
@@ -30,16 +40,40 @@ class RingTopology : public BasicLogicalTopology {
       Dimension dimension,
       int id,
       std::vector<int> NPUs);
-  virtual int get_receiver(int node_id, Direction direction);
-  virtual int get_sender(int node_id, Direction direction);
+  int get_receiver(int node_id, Direction direction);
+  int get_sender(int node_id, Direction direction);
+  std::vector<int> get_peers(int node_id, Direction direction);
   int get_nodes_in_ring();
   bool is_enabled();
   Dimension get_dimension();
   int get_index_in_ring();
+  int get_index_of(int node_id) {
+    if (offset > 0) {
+      int distance = node_id - first_node;
+      if (distance < 0 || distance % offset != 0 ||
+          distance / offset >= total_nodes_in_ring) {
+        return -1;
+      }
+      return distance / offset;
+    }
+    auto it = node_table->id_to_index.find(node_id);
+    if (it == node_table->id_to_index.end()) {
+      return -1;
+    }
+    return it->second;
+  }
+  int get_node_id_at_index(int index) {
+    if (offset > 0) {
+      return first_node + index * offset;
+    }
+    return node_table->nodes[index];
+  }
 
  private:
-  std::unordered_map<int, int> id_to_index;
-  std::unordered_map<int, int> index_to_id;
+  // Homogeneous rings (offset > 0) map ids to indices arithmetically, custom
+  // rings through the node table they share with the other NPUs of the ring.
+  RingNodeTable* node_table;
+  int first_node;
 
   std::string name;
   int id;
@@ -48,7 +82,6 @@ class RingTopology : public BasicLogicalTopology {
   int index_in_ring;
   Dimension dimension;
 
-  virtual int get_receiver_homogeneous(int node_id, Direction direction, int offset);
 };
 
 } // namespace AstraSim
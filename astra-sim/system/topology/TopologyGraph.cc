@@ -0,0 +1,102 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "astra-sim/system/topology/TopologyGraph.hh"
+
+#include <fstream>
+#include <iostream>
+
+#include "astra-sim/json.hpp"
+
+using namespace std;
+using namespace AstraSim;
+using json = nlohmann::json;
+
+TopologyGraph::TopologyGraph(string path) {
+  ifstream inFile;
+  inFile.open(path);
+  if (!inFile) {
+    cerr << "Unable to open file: " << path << endl;
+    exit(1);
+  }
+  json j;
+  inFile >> j;
+  inFile.close();
+  if (!j.contains("npus") || !j.contains("links")) {
+    cerr << "the logical topology file " << path
+         << " should define npus and links" << endl;
+    exit(1);
+  }
+  npus = j["npus"];
+  switches = 0;
+  if (j.contains("switches")) {
+    switches = j["switches"];
+  }
+  adjacency.resize(npus + switches);
+  vector<vector<int>> links = j["links"];
+  for (auto& link : links) {
+    if (link.size() != 2 || link[0] < 0 || link[1] < 0 ||
+        link[0] >= npus + switches || link[1] >= npus + switches) {
+      cerr << "invalid link in the logical topology file " << path << endl;
+      exit(1);
+    }
+    adjacency[link[0]].push_back(link[1]);
+    adjacency[link[1]].push_back(link[0]);
+  }
+  generate_ring_order();
+}
+
+vector<int> TopologyGraph::get_distances(int node) {
+  vector<int> distance(adjacency.size(), -1);
+  vector<int> frontier;
+  distance[node] = 0;
+  frontier.push_back(node);
+  for (int head = 0; head < frontier.size(); head++) {
+    int current = frontier[head];
+    for (int next : adjacency[current]) {
+      if (distance[next] == -1) {
+        distance[next] = distance[current] + 1;
+        frontier.push_back(next);
+      }
+    }
+  }
+  return distance;
+}
+
+// Nearest neighbor tour: starting from NPU 0, always move to the closest NPU
+// not visited yet (the lowest id among the equally close ones). On
+// hierarchical fabrics this visits all the NPUs under a switch before leaving
+// it, which is what the rings of NCCL-like libraries do.
+void TopologyGraph::generate_ring_order() {
+  vector<bool> visited(npus, false);
+  int current = 0;
+  ring_hops = 0;
+  visited[current] = true;
+  ring_order.push_back(current);
+  while (ring_order.size() < npus) {
+    vector<int> distance = get_distances(current);
+    int next = -1;
+    for (int npu = 0; npu < npus; npu++) {
+      if (visited[npu] || distance[npu] == -1) {
+        continue;
+      }
+      if (next == -1 || distance[npu] < distance[next]) {
+        next = npu;
+      }
+    }
+    if (next == -1) {
+      cerr << "the NPUs of the logical topology graph are not connected"
+           << endl;
+      exit(1);
+    }
+    ring_hops += distance[next];
+    visited[next] = true;
+    ring_order.push_back(next);
+    current = next;
+  }
+  if (npus > 1) {
+    ring_hops += get_distances(current)[ring_order[0]];
+  }
+}
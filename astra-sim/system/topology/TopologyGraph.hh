@@ -0,0 +1,39 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#ifndef __TOPOLOGY_GRAPH_HH__
+#define __TOPOLOGY_GRAPH_HH__
+
+#include <string>
+#include <vector>
+
+namespace AstraSim {
+
+// A network described as a graph of NPUs, switches and links, read from the
+// file given by logical-topology-file. Nodes 0..npus-1 are the NPUs and the
+// following ones the switches. The graph only decides the order in which the
+// NPUs are placed in the logical rings and trees, so that neighbors in the
+// logical topology are close to each other in the fabric.
+class TopologyGraph {
+ public:
+  TopologyGraph(std::string path);
+  // hop distance from node to every other node (-1 if unreachable)
+  std::vector<int> get_distances(int node);
+
+  int npus;
+  int switches;
+  std::vector<std::vector<int>> adjacency;
+  // a short cycle through all the NPUs, used by the rings and the trees
+  std::vector<int> ring_order;
+  // the number of links crossed by one trip around ring_order
+  int ring_hops;
+
+ private:
+  void generate_ring_order();
+};
+
+} // namespace AstraSim
+
+#endif /* __TOPOLOGY_GRAPH_HH__ */
@@ -0,0 +1,85 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "astra-sim/system/topology/TopologyRegistry.hh"
+
+using namespace std;
+using namespace AstraSim;
+
+map<tuple<BinaryTree::TreeType, int, int, int>, BinaryTree*>
+    TopologyRegistry::binary_trees;
+map<pair<BinaryTree::TreeType, vector<int>>, BinaryTree*>
+    TopologyRegistry::ordered_binary_trees;
+map<vector<int>, RingNodeTable*> TopologyRegistry::ring_node_tables;
+map<string, TopologyGraph*> TopologyRegistry::topology_graphs;
+
+BinaryTree* TopologyRegistry::get_binary_tree(
+    BinaryTree::TreeType tree_type,
+    int total_tree_nodes,
+    int start,
+    int stride) {
+  tuple<BinaryTree::TreeType, int, int, int> key =
+      make_tuple(tree_type, total_tree_nodes, start, stride);
+  auto it = binary_trees.find(key);
+  if (it != binary_trees.end()) {
+    return it->second;
+  }
+  BinaryTree* tree =
+      new BinaryTree(tree_type, total_tree_nodes, start, stride);
+  binary_trees[key] = tree;
+  return tree;
+}
+
+BinaryTree* TopologyRegistry::get_binary_tree(
+    BinaryTree::TreeType tree_type,
+    const vector<int>& NPUs) {
+  pair<BinaryTree::TreeType, vector<int>> key = make_pair(tree_type, NPUs);
+  auto it = ordered_binary_trees.find(key);
+  if (it != ordered_binary_trees.end()) {
+    return it->second;
+  }
+  BinaryTree* tree = new BinaryTree(tree_type, NPUs);
+  ordered_binary_trees[key] = tree;
+  return tree;
+}
+
+RingNodeTable* TopologyRegistry::get_ring_node_table(const vector<int>& NPUs) {
+  auto it = ring_node_tables.find(NPUs);
+  if (it != ring_node_tables.end()) {
+    return it->second;
+  }
+  RingNodeTable* table = new RingNodeTable(NPUs);
+  ring_node_tables[NPUs] = table;
+  return table;
+}
+
+TopologyGraph* TopologyRegistry::get_topology_graph(string path) {
+  auto it = topology_graphs.find(path);
+  if (it != topology_graphs.end()) {
+    return it->second;
+  }
+  TopologyGraph* graph = new TopologyGraph(path);
+  topology_graphs[path] = graph;
+  return graph;
+}
+
+void TopologyRegistry::clear() {
+  for (auto& tree : binary_trees) {
+    delete tree.second;
+  }
+  binary_trees.clear();
+  for (auto& table : ring_node_tables) {
+    delete table.second;
+  }
+  ring_node_tables.clear();
+  for (auto& tree : ordered_binary_trees) {
+    delete tree.second;
+  }
+  ordered_binary_trees.clear();
+  for (auto& graph : topology_graphs) {
+    delete graph.second;
+  }
+  topology_graphs.clear();
+}
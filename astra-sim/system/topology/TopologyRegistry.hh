@@ -0,0 +1,52 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#ifndef __TOPOLOGY_REGISTRY_HH__
+#define __TOPOLOGY_REGISTRY_HH__
+
+#include <map>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "astra-sim/system/topology/BinaryTree.hh"
+#include "astra-sim/system/topology/RingTopology.hh"
+#include "astra-sim/system/topology/TopologyGraph.hh"
+
+namespace AstraSim {
+
+// Every Sys builds its own logical topologies, but the parts of them that do
+// not depend on the rank (the trees and the node tables of custom rings) are
+// the same for all the NPUs that take part in them. The registry builds each
+// of them once and hands the same instance to every Sys, which only keeps
+// its rank-specific view. Entries are owned by the registry and released by
+// clear() once the last Sys is gone.
+class TopologyRegistry {
+ public:
+  static BinaryTree* get_binary_tree(
+      BinaryTree::TreeType tree_type,
+      int total_tree_nodes,
+      int start,
+      int stride);
+  static BinaryTree* get_binary_tree(
+      BinaryTree::TreeType tree_type,
+      const std::vector<int>& NPUs);
+  static RingNodeTable* get_ring_node_table(const std::vector<int>& NPUs);
+  // the graph of a logical-topology-file, parsed once per file
+  static TopologyGraph* get_topology_graph(std::string path);
+  static void clear();
+
+ private:
+  static std::map<std::tuple<BinaryTree::TreeType, int, int, int>, BinaryTree*>
+      binary_trees;
+  static std::map<std::pair<BinaryTree::TreeType, std::vector<int>>, BinaryTree*>
+      ordered_binary_trees;
+  static std::map<std::vector<int>, RingNodeTable*> ring_node_tables;
+  static std::map<std::string, TopologyGraph*> topology_graphs;
+};
+
+} // namespace AstraSim
+
+#endif /* __TOPOLOGY_REGISTRY_HH__ */
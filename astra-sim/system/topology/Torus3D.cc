@@ -41,13 +41,15 @@ int Torus3D::get_num_of_dimensions() {
   return 3;
 }
 
+// the dimensions follow the physical order: local (fastest), horizontal
+// (stride local_dim), then vertical (stride local_dim * horizontal_dim)
 int Torus3D::get_num_of_nodes_in_dimension(int dimension) {
   if (dimension == 0) {
     return local_dimension->get_num_of_nodes_in_dimension(0);
   } else if (dimension == 1) {
-    return vertical_dimension->get_num_of_nodes_in_dimension(0);
-  } else if (dimension == 2) {
     return horizontal_dimension->get_num_of_nodes_in_dimension(0);
+  } else if (dimension == 2) {
+    return vertical_dimension->get_num_of_nodes_in_dimension(0);
   }
   return -1;
 }
@@ -57,9 +59,9 @@ BasicLogicalTopology* Torus3D::get_basic_topology_at_dimension(
   if (dimension == 0) {
     return local_dimension;
   } else if (dimension == 1) {
-    return vertical_dimension;
-  } else if (dimension == 2) {
     return horizontal_dimension;
+  } else if (dimension == 2) {
+    return vertical_dimension;
   }
   return NULL;
 }
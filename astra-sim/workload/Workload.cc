@@ -11,7 +11,9 @@ LICENSE file in the root directory of this source tree.
 #include "astra-sim/system/RecvPacketEventHandlerData.hh"
 #include "astra-sim/system/SendPacketEventHandlerData.hh"
 #include "astra-sim/system/WorkloadLayerHandlerData.hh"
+#include "astra-sim/system/scheduling/PlacementOptimizer.hh"
 
+#include <algorithm>
 #include <iostream>
 
 using namespace std;
@@ -28,17 +30,25 @@ Workload::Workload(
     string comm_group_filename) {
   this->et_feeder =
     new ETFeeder(eg_filename + "." + to_string(sys->id) + ".eg");
-  this->comm_group = nullptr;
   // TODO: parametrize the number of available hardware resources
   this->hw_resource = new HardwareResource(1);
   this->sys = sys;
   initialize_comm_group(comm_group_filename);
   this->is_finished = false;
+  this->comm_bucket_size = 0;
+  this->comm_bucket_epoch = 0;
+  this->bucketed_comm_nodes = 0;
+  this->issued_comm_buckets = 0;
+  this->bucketed_streams = 0;
+  this->bucketed_phases = 0;
+  this->unfused_streams = 0;
+  this->unfused_phases = 0;
 }
 
 Workload::~Workload() {
-  if (this->comm_group != nullptr)
-    delete this->comm_group;
+  for (auto& comm_group : comm_groups) {
+    delete comm_group.second;
+  }
   if (this->et_feeder != nullptr)
     delete this->et_feeder;
 }
@@ -47,47 +57,145 @@ void Workload::initialize_comm_group(string comm_group_filename)
 {
   // communicator group input file is not given
   if (comm_group_filename.find("empty") != std::string::npos) {
-    comm_group = nullptr;
     return;
   }
 
   ifstream inFile;
   json j;
   inFile.open(comm_group_filename);
+  if (!inFile) {
+    Sys::sys_panic("Unable to open the communicator group file: " + comm_group_filename);
+  }
   inFile >> j;
 
-  for (json::iterator it = j.begin(); it != j.end(); ++it) {
-    bool in_comm_group = false;
-
-    for (auto id: it.value()) {
-      if (id == sys->id) {
-        in_comm_group = true;
+  // {"<group id>": [NPUs], ...} (or a list of instances of the group,
+  // [[NPUs], [NPUs], ...]), or a list of NPU lists whose group ids are their
+  // positions (starting from 1)
+  std::map<int, std::vector<int>> groups;
+  if (j.is_array()) {
+    for (int i = 0; i < j.size(); i++) {
+      std::vector<int> involved_NPUs = j[i];
+      groups[i + 1] = involved_NPUs;
+    }
+  } else {
+    for (json::iterator it = j.begin(); it != j.end(); ++it) {
+      // the group ids are the comm_tag of the collectives of the group
+      int group_id = -1;
+      try {
+        size_t parsed = 0;
+        group_id = stoi(it.key(), &parsed);
+        if (parsed != it.key().size()) {
+          group_id = -1;
+        }
+      } catch (...) {
+        group_id = -1;
+      }
+      if (group_id < 0) {
+        Sys::sys_panic(
+            "Invalid group id \"" + it.key() + "\" in the communicator group file " +
+            comm_group_filename + ": group ids should be non-negative integers");
+      }
+      if (it.value().size() > 0 && it.value()[0].is_array()) {
+        // several instances of the group (e.g. one TP group per node)
+        for (auto& instance : it.value()) {
+          std::vector<int> involved_NPUs = instance;
+          if (std::find(involved_NPUs.begin(), involved_NPUs.end(), sys->id) !=
+              involved_NPUs.end()) {
+            groups[group_id] = involved_NPUs;
+          }
+        }
+      } else {
+        std::vector<int> involved_NPUs = it.value();
+        groups[group_id] = involved_NPUs;
       }
     }
+  }
 
-    if (in_comm_group) {
-      std::vector<int> involved_NPUs;
-      for (auto id: it.value()) {
-        involved_NPUs.push_back(id);
-      }
-      comm_group = new CommunicatorGroup(1, involved_NPUs, sys);
-      // Note: All NPUs should create comm group with identical ids if they want to communicate with each other
+  for (auto& group : groups) {
+    if (std::find(group.second.begin(), group.second.end(), sys->id) !=
+        group.second.end()) {
+      // the group id selects the stream id range of the group, so all the
+      // NPUs of a group share it
+      comm_groups[group.first] =
+        new CommunicatorGroup(group.first, group.second, sys);
     }
   }
 }
 
+// The group of a collective is the one whose id is the comm_tag of the node.
+// Traces without group ids (an unknown tag) keep using the only group of the
+// NPU, if it has one. With several groups the tag must name one of them.
+CommunicatorGroup* Workload::get_comm_group(shared_ptr<Chakra::ETFeederNode> node)
+{
+  if (comm_groups.empty()) {
+    return nullptr;
+  }
+  auto it = comm_groups.find(node->getChakraNode()->comm_tag());
+  if (it != comm_groups.end()) {
+    return it->second;
+  }
+  if (comm_groups.size() == 1) {
+    return comm_groups.begin()->second;
+  }
+  Sys::sys_panic(
+      "NPU " + to_string(sys->id) + " belongs to several communicator groups and the comm_tag " +
+      to_string(node->getChakraNode()->comm_tag()) + " of node " +
+      to_string(node->getChakraNode()->id()) + " matches none of them");
+  return nullptr;
+}
+
 void Workload::issue_dep_free_nodes() {
   std::queue<shared_ptr<Chakra::ETFeederNode>> push_back_queue;
+  std::queue<shared_ptr<Chakra::ETFeederNode>> all_reduce_queue;
+  std::queue<shared_ptr<Chakra::ETFeederNode>> all_to_all_queue;
   shared_ptr<Chakra::ETFeederNode> node = et_feeder->getNextIssuableNode();
   while (node != nullptr) {
-    if (hw_resource->is_available(node)) {
-      issue(node);
-    } else {
+    if (!hw_resource->is_available(node)) {
       push_back_queue.push(node);
+    } else if ((sys->comm_fusion_bucket_size > 0)
+        && (node->getChakraNode()->node_type() == ChakraNodeType::COMM_COLL_NODE)
+        && (node->getChakraNode()->comm_type() == ChakraCollectiveCommType::ALL_REDUCE)) {
+      add_to_comm_bucket(node);
+    } else if (sys->fuse_all_reduce_all_to_all
+        && (node->getChakraNode()->node_type() == ChakraNodeType::COMM_COLL_NODE)
+        && (node->getChakraNode()->comm_type() == ChakraCollectiveCommType::ALL_REDUCE)) {
+      all_reduce_queue.push(node);
+    } else if (sys->fuse_all_reduce_all_to_all
+        && (node->getChakraNode()->node_type() == ChakraNodeType::COMM_COLL_NODE)
+        && (node->getChakraNode()->comm_type() == ChakraCollectiveCommType::ALL_TO_ALL)) {
+      all_to_all_queue.push(node);
+    } else {
+      issue(node);
     }
     node = et_feeder->getNextIssuableNode();
   }
 
+  // all-reduces and all-to-alls that become ready together are fused
+  while (!all_reduce_queue.empty() && !all_to_all_queue.empty()) {
+    if (get_comm_group(all_reduce_queue.front()) == get_comm_group(all_to_all_queue.front())) {
+      issue_fused_comm(all_reduce_queue.front(), all_to_all_queue.front());
+    } else {
+      issue(all_reduce_queue.front());
+      issue(all_to_all_queue.front());
+    }
+    all_reduce_queue.pop();
+    all_to_all_queue.pop();
+  }
+  while (!all_reduce_queue.empty()) {
+    issue(all_reduce_queue.front());
+    all_reduce_queue.pop();
+  }
+  while (!all_to_all_queue.empty()) {
+    issue(all_to_all_queue.front());
+    all_to_all_queue.pop();
+  }
+
+  // without a window, a bucket only gathers the all-reduces that become ready
+  // together
+  if ((sys->comm_fusion_window == 0) && !comm_bucket.empty()) {
+    flush_comm_bucket();
+  }
+
   while (!push_back_queue.empty()) {
     shared_ptr<Chakra::ETFeederNode> node = push_back_queue.front();
     et_feeder->pushBackIssuableNode(node->getChakraNode()->id());
@@ -95,6 +203,87 @@ void Workload::issue_dep_free_nodes() {
   }
 }
 
+void Workload::add_to_comm_bucket(shared_ptr<Chakra::ETFeederNode> node) {
+  // all-reduces over different dimensions or groups can not share a collective
+  if (!comm_bucket.empty()) {
+    shared_ptr<Chakra::ETFeederNode> first = comm_bucket.front();
+    bool same_dims =
+      first->getChakraNode()->involved_dim_size() == node->getChakraNode()->involved_dim_size() &&
+      get_comm_group(first) == get_comm_group(node);
+    for (int i = 0; same_dims && i < node->getChakraNode()->involved_dim_size(); i++) {
+      same_dims =
+        first->getChakraNode()->involved_dim(i) == node->getChakraNode()->involved_dim(i);
+    }
+    if (!same_dims) {
+      flush_comm_bucket();
+    }
+  }
+
+  hw_resource->occupy(node);
+  comm_bucket.push_back(node);
+  comm_bucket_size += node->getChakraNode()->comm_size();
+
+  if (comm_bucket_size >= sys->comm_fusion_bucket_size) {
+    flush_comm_bucket();
+  } else if ((sys->comm_fusion_window > 0) && (comm_bucket.size() == 1)) {
+    sys->register_event(
+        this,
+        EventType::CommBucketTimeout,
+        new IntData(comm_bucket_epoch),
+        sys->comm_fusion_window);
+  }
+}
+
+void Workload::flush_comm_bucket() {
+  if (comm_bucket.empty()) {
+    return;
+  }
+  shared_ptr<Chakra::ETFeederNode> first = comm_bucket.front();
+
+  if (sys->trace_enabled) {
+    for (auto node : comm_bucket) {
+      cout << "issue,sys->id=" << sys->id
+        << ",tick=" << Sys::boostedTick()
+        << ",node->id=" << node->getChakraNode()->id()
+        << ",node->name=" << node->getChakraNode()->name()
+        << ",bucket_of=" << first->getChakraNode()->id() << endl;
+    }
+  }
+
+  vector<bool> involved_dim;
+  for (int i = 0; i < first->getChakraNode()->involved_dim_size(); i++) {
+    involved_dim.push_back(first->getChakraNode()->involved_dim(i));
+  }
+
+  uint64_t streams = sys->created_streams;
+  uint64_t phases = sys->created_phases;
+  DataSet *fp = sys->generate_all_reduce(
+      comm_bucket_size,
+      involved_dim,
+      get_comm_group(first),
+      first->getChakraNode()->comm_priority());
+  streams = sys->created_streams - streams;
+  phases = sys->created_phases - phases;
+  // a collective is cut into the same number of chunks whatever its size
+  // (preferred-dataset-splits), so each node of the bucket issued on its own
+  // would have created as many streams and phases as the whole bucket
+  bucketed_streams += streams;
+  bucketed_phases += phases;
+  unfused_streams += streams * comm_bucket.size();
+  unfused_phases += phases * comm_bucket.size();
+  for (auto node : comm_bucket) {
+    collective_comm_node_id_map[fp->my_id].push_back(node->getChakraNode()->id());
+  }
+  fp->set_notifier(this, EventType::CollectiveCommunicationFinished);
+
+  bucketed_comm_nodes += comm_bucket.size();
+  issued_comm_buckets++;
+  comm_bucket.clear();
+  comm_bucket_size = 0;
+  // a pending timeout belongs to the bucket that was just issued
+  comm_bucket_epoch++;
+}
+
 void Workload::issue(shared_ptr<Chakra::ETFeederNode> node) {
   if (node->getChakraNode()->node_type() == ChakraNodeType::COMP_NODE) {
     if ((node->getChakraNode()->simulated_run_time() == 0)
@@ -160,6 +349,7 @@ void Workload::issue_comm(shared_ptr<Chakra::ETFeederNode> node) {
   int src, dst;
 
   hw_resource->occupy(node);
+  CommunicatorGroup* comm_group = get_comm_group(node);
 
   vector<bool> involved_dim;
   for (int i = 0; i < node->getChakraNode()->involved_dim_size(); i++) {
@@ -173,7 +363,18 @@ void Workload::issue_comm(shared_ptr<Chakra::ETFeederNode> node) {
           involved_dim,
           comm_group,
           node->getChakraNode()->comm_priority());
-      collective_comm_node_id_map[fp->my_id] = node->getChakraNode()->id();
+      collective_comm_node_id_map[fp->my_id].push_back(node->getChakraNode()->id());
+      fp->set_notifier(this, EventType::CollectiveCommunicationFinished);
+
+    } else if (node->getChakraNode()->comm_type() == ChakraCollectiveCommType::ALL_TO_ALL &&
+               sys->all_to_allv_skew > 0) {
+      // the ET has no per-destination sizes, they are drawn from the skew
+      DataSet *fp = sys->generate_all_to_allv(
+          node->getChakraNode()->comm_size(),
+          involved_dim,
+          comm_group,
+          node->getChakraNode()->comm_priority());
+      collective_comm_node_id_map[fp->my_id].push_back(node->getChakraNode()->id());
       fp->set_notifier(this, EventType::CollectiveCommunicationFinished);
 
     } else if (node->getChakraNode()->comm_type() == ChakraCollectiveCommType::ALL_TO_ALL) {
@@ -182,7 +383,7 @@ void Workload::issue_comm(shared_ptr<Chakra::ETFeederNode> node) {
           involved_dim,
           comm_group,
           node->getChakraNode()->comm_priority());
-      collective_comm_node_id_map[fp->my_id] = node->getChakraNode()->id();
+      collective_comm_node_id_map[fp->my_id].push_back(node->getChakraNode()->id());
       fp->set_notifier(this, EventType::CollectiveCommunicationFinished);
 
     } else if (node->getChakraNode()->comm_type() == ChakraCollectiveCommType::ALL_GATHER) {
@@ -191,18 +392,70 @@ void Workload::issue_comm(shared_ptr<Chakra::ETFeederNode> node) {
           involved_dim,
           comm_group,
           node->getChakraNode()->comm_priority());
-      collective_comm_node_id_map[fp->my_id] = node->getChakraNode()->id();
+      collective_comm_node_id_map[fp->my_id].push_back(node->getChakraNode()->id());
       fp->set_notifier(this, EventType::CollectiveCommunicationFinished);
 
-    } else if (node->getChakraNode()->comm_type() == ChakraCollectiveCommType::REDUCE_SCATTER) {
+    } else if (node->getChakraNode()->comm_type() == ChakraCollectiveCommType::REDUCE_SCATTER ||
+               node->getChakraNode()->comm_type() == ChakraCollectiveCommType::REDUCE_SCATTER_BLOCK) {
       DataSet *fp = sys->generate_reduce_scatter(
           node->getChakraNode()->comm_size(),
           involved_dim,
           comm_group,
           node->getChakraNode()->comm_priority());
-      collective_comm_node_id_map[fp->my_id] = node->getChakraNode()->id();
+      collective_comm_node_id_map[fp->my_id].push_back(node->getChakraNode()->id());
       fp->set_notifier(this, EventType::CollectiveCommunicationFinished);
 
+    } else if (node->getChakraNode()->comm_type() == ChakraCollectiveCommType::BROADCAST) {
+      // the root of a rooted collective is given by comm_src
+      DataSet *fp = sys->generate_broadcast(
+          node->getChakraNode()->comm_size(),
+          node->getChakraNode()->comm_src(),
+          involved_dim,
+          comm_group,
+          node->getChakraNode()->comm_priority());
+      collective_comm_node_id_map[fp->my_id].push_back(node->getChakraNode()->id());
+      fp->set_notifier(this, EventType::CollectiveCommunicationFinished);
+
+    } else if (node->getChakraNode()->comm_type() == ChakraCollectiveCommType::REDUCE) {
+      DataSet *fp = sys->generate_reduce(
+          node->getChakraNode()->comm_size(),
+          node->getChakraNode()->comm_src(),
+          involved_dim,
+          comm_group,
+          node->getChakraNode()->comm_priority());
+      collective_comm_node_id_map[fp->my_id].push_back(node->getChakraNode()->id());
+      fp->set_notifier(this, EventType::CollectiveCommunicationFinished);
+
+    } else if (node->getChakraNode()->comm_type() == ChakraCollectiveCommType::GATHER) {
+      DataSet *fp = sys->generate_gather(
+          node->getChakraNode()->comm_size(),
+          node->getChakraNode()->comm_src(),
+          involved_dim,
+          comm_group,
+          node->getChakraNode()->comm_priority());
+      collective_comm_node_id_map[fp->my_id].push_back(node->getChakraNode()->id());
+      fp->set_notifier(this, EventType::CollectiveCommunicationFinished);
+
+    } else if (node->getChakraNode()->comm_type() == ChakraCollectiveCommType::SCATTER) {
+      DataSet *fp = sys->generate_scatter(
+          node->getChakraNode()->comm_size(),
+          node->getChakraNode()->comm_src(),
+          involved_dim,
+          comm_group,
+          node->getChakraNode()->comm_priority());
+      collective_comm_node_id_map[fp->my_id].push_back(node->getChakraNode()->id());
+      fp->set_notifier(this, EventType::CollectiveCommunicationFinished);
+
+    } else if (node->getChakraNode()->comm_type() == ChakraCollectiveCommType::BARRIER) {
+      DataSet *fp = sys->generate_barrier(
+          involved_dim,
+          comm_group,
+          node->getChakraNode()->comm_priority());
+      collective_comm_node_id_map[fp->my_id].push_back(node->getChakraNode()->id());
+      fp->set_notifier(this, EventType::CollectiveCommunicationFinished);
+
+    } else {
+      Sys::sys_panic("unsupported collective communication type in the workload");
     }
   } else if (node->getChakraNode()->node_type() == ChakraNodeType::COMM_SEND_NODE) {
     sim_request snd_req;
@@ -244,6 +497,42 @@ void Workload::issue_comm(shared_ptr<Chakra::ETFeederNode> node) {
   }
 }
 
+void Workload::issue_fused_comm(
+    shared_ptr<Chakra::ETFeederNode> all_reduce_node,
+    shared_ptr<Chakra::ETFeederNode> all_to_all_node) {
+  if (sys->trace_enabled) {
+    cout << "issue,sys->id=" << sys->id
+      << ",tick=" << Sys::boostedTick()
+      << ",node->id=" << all_reduce_node->getChakraNode()->id()
+      << ",node->name=" << all_reduce_node->getChakraNode()->name()
+      << ",fused_with=" << all_to_all_node->getChakraNode()->id() << endl;
+  }
+
+  hw_resource->occupy(all_reduce_node);
+  hw_resource->occupy(all_to_all_node);
+
+  // each pattern runs over the dimensions of its own node
+  vector<bool> all_reduce_involved_dim;
+  for (int i = 0; i < all_reduce_node->getChakraNode()->involved_dim_size(); i++) {
+    all_reduce_involved_dim.push_back(all_reduce_node->getChakraNode()->involved_dim(i));
+  }
+  vector<bool> all_to_all_involved_dim;
+  for (int i = 0; i < all_to_all_node->getChakraNode()->involved_dim_size(); i++) {
+    all_to_all_involved_dim.push_back(all_to_all_node->getChakraNode()->involved_dim(i));
+  }
+
+  DataSet *fp = sys->generate_all_reduce_all_to_all(
+      all_reduce_node->getChakraNode()->comm_size(),
+      all_to_all_node->getChakraNode()->comm_size(),
+      all_reduce_involved_dim,
+      all_to_all_involved_dim,
+      get_comm_group(all_reduce_node),
+      all_reduce_node->getChakraNode()->comm_priority());
+  collective_comm_node_id_map[fp->my_id].push_back(all_reduce_node->getChakraNode()->id());
+  collective_comm_node_id_map[fp->my_id].push_back(all_to_all_node->getChakraNode()->id());
+  fp->set_notifier(this, EventType::CollectiveCommunicationFinished);
+}
+
 void Workload::skip_invalid(shared_ptr<Chakra::ETFeederNode> node) {
   et_feeder->freeChildrenNodes(node->getChakraNode()->id());
   et_feeder->removeNode(node->getChakraNode()->id());
@@ -256,23 +545,36 @@ void Workload::call(EventType event, CallData* data) {
 
   if (event == EventType::CollectiveCommunicationFinished) {
     IntData* int_data = (IntData*)data;
-    uint64_t node_id = collective_comm_node_id_map[int_data->data];
-    shared_ptr<Chakra::ETFeederNode> node = et_feeder->lookupNode(node_id);
+    vector<uint64_t> node_ids = collective_comm_node_id_map[int_data->data];
+    collective_comm_node_id_map.erase(int_data->data);
 
-    if (sys->trace_enabled) {
-      cout << "callback,sys->id=" << sys->id
-        << ",tick=" << Sys::boostedTick()
-        << ",node->id=" << node->getChakraNode()->id()
-        << ",node->name=" << node->getChakraNode()->name() << endl;
-    }
+    for (auto node_id : node_ids) {
+      shared_ptr<Chakra::ETFeederNode> node = et_feeder->lookupNode(node_id);
 
-    hw_resource->release(node);
+      if (sys->trace_enabled) {
+        cout << "callback,sys->id=" << sys->id
+          << ",tick=" << Sys::boostedTick()
+          << ",node->id=" << node->getChakraNode()->id()
+          << ",node->name=" << node->getChakraNode()->name() << endl;
+      }
+
+      hw_resource->release(node);
 
-    et_feeder->freeChildrenNodes(node_id);
+      et_feeder->freeChildrenNodes(node_id);
+    }
 
     issue_dep_free_nodes();
 
-    et_feeder->removeNode(node_id);
+    for (auto node_id : node_ids) {
+      et_feeder->removeNode(node_id);
+    }
+
+  } else if (event == EventType::CommBucketTimeout) {
+    IntData* int_data = (IntData*)data;
+    if (int_data->data == comm_bucket_epoch) {
+      flush_comm_bucket();
+    }
+    delete int_data;
 
   } else {
     if (data == nullptr) {
@@ -313,5 +615,16 @@ void Workload::fire() {
 
 void Workload::report() {
   Tick curr_tick = Sys::boostedTick();
-  cout << "sys[" << sys->id << "] finished, " << curr_tick << " cycles" << endl;
+  cout << "sys[" << sys->id << "] finished, " << curr_tick << " cycles, "
+    << sys->scheduled_events << " events scheduled" << endl;
+  if (sys->placement_optimizer != nullptr) {
+    sys->placement_optimizer->search(curr_tick, comm_groups);
+  }
+  if (sys->comm_fusion_bucket_size > 0) {
+    cout << "sys[" << sys->id << "] comm fusion: " << bucketed_comm_nodes
+      << " all-reduce nodes issued as " << issued_comm_buckets
+      << " collectives with " << bucketed_streams << " streams and "
+      << bucketed_phases << " phases, instead of " << unfused_streams
+      << " streams and " << unfused_phases << " phases unfused" << endl;
+  }
 }
@@ -6,6 +6,7 @@ LICENSE file in the root directory of this source tree.
 #ifndef __WORKLOAD_HH__
 #define __WORKLOAD_HH__
 
+#include <map>
 #include <memory>
 #include <string>
 
@@ -28,12 +29,18 @@ class Workload : Callable {
 
   // communicator groups
   void initialize_comm_group(std::string comm_group_filename);
+  CommunicatorGroup* get_comm_group(std::shared_ptr<Chakra::ETFeederNode> node);
 
   // event-based simulation
   void issue_dep_free_nodes();
   void issue(std::shared_ptr<Chakra::ETFeederNode> node);
   void issue_comp(std::shared_ptr<Chakra::ETFeederNode> node);
   void issue_comm(std::shared_ptr<Chakra::ETFeederNode> node);
+  void issue_fused_comm(
+      std::shared_ptr<Chakra::ETFeederNode> all_reduce_node,
+      std::shared_ptr<Chakra::ETFeederNode> all_to_all_node);
+  void add_to_comm_bucket(std::shared_ptr<Chakra::ETFeederNode> node);
+  void flush_comm_bucket();
   void skip_invalid(std::shared_ptr<Chakra::ETFeederNode> node);
   void call(EventType event, CallData* data);
   void fire();
@@ -42,10 +49,22 @@ class Workload : Callable {
   void report();
 
   Chakra::ETFeeder* et_feeder;
-  CommunicatorGroup* comm_group;
+  std::map<int, CommunicatorGroup*> comm_groups;
   HardwareResource* hw_resource;
   Sys* sys;
-  std::map<int, uint64_t> collective_comm_node_id_map;
+  std::map<int, std::vector<uint64_t>> collective_comm_node_id_map;
+
+  // all-reduce bucketing
+  std::vector<std::shared_ptr<Chakra::ETFeederNode>> comm_bucket;
+  uint64_t comm_bucket_size;
+  int comm_bucket_epoch;
+  uint64_t bucketed_comm_nodes;
+  uint64_t issued_comm_buckets;
+  // streams and phases of the buckets, and of their nodes issued one by one
+  uint64_t bucketed_streams;
+  uint64_t bucketed_phases;
+  uint64_t unfused_streams;
+  uint64_t unfused_phases;
   bool is_finished;
 };
 
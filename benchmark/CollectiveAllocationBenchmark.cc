@@ -0,0 +1,185 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+// Heap allocations per collective of the collective generation path
+// (Sys::generate_all_reduce down to the streams and their phases), counted by
+// replacing the global operator new. The Sys of NPU 0 is built on a network
+// and a memory that drop every request, so nothing runs after the streams
+// are created, and on a feeder with an empty trace, since the collectives
+// are issued directly.
+//
+// Measured on a 4x4x4 ring all-reduce of 1 MB (benchmark/allocation_sys.json):
+//   preferred-dataset-splits  before move-only phases  after
+//   16                        356                      177
+//   256                       5636                     2817
+//
+// Built by hand, as it stands in for the Chakra feeder: compile it with the
+// system and workload sources, and the Chakra sources other than et_feeder:
+//   g++ -O2 -std=c++11 -I. -Iextern/graph_frontend/chakra
+//       benchmark/CollectiveAllocationBenchmark.cc <sources> -lprotobuf
+// Usage: CollectiveAllocationBenchmark [system_config] [collectives]
+
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "astra-sim/system/AstraMemoryAPI.hh"
+#include "astra-sim/system/AstraNetworkAPI.hh"
+#include "astra-sim/system/Sys.hh"
+#include "extern/graph_frontend/chakra/et_feeder/et_feeder.h"
+
+using namespace std;
+using namespace AstraSim;
+
+static long allocations = 0;
+static bool counting = false;
+
+void* operator new(size_t size) {
+  if (counting) {
+    allocations++;
+  }
+  void* pointer = malloc(size == 0 ? 1 : size);
+  if (pointer == nullptr) {
+    throw bad_alloc();
+  }
+  return pointer;
+}
+
+void* operator new[](size_t size) {
+  return operator new(size);
+}
+
+void operator delete(void* pointer) noexcept {
+  free(pointer);
+}
+
+void operator delete[](void* pointer) noexcept {
+  free(pointer);
+}
+
+namespace Chakra {
+
+ETFeeder::ETFeeder(string filename) {}
+
+void ETFeeder::freeChildrenNodes(uint64_t node_id) {}
+
+void ETFeeder::removeNode(uint64_t node_id) {}
+
+bool ETFeeder::hasNodesToIssue() {
+  return false;
+}
+
+shared_ptr<ETFeederNode> ETFeeder::getNextIssuableNode() {
+  return nullptr;
+}
+
+void ETFeeder::pushBackIssuableNode(uint64_t node_id) {}
+
+shared_ptr<ETFeederNode> ETFeeder::lookupNode(uint64_t node_id) {
+  return nullptr;
+}
+
+shared_ptr<ChakraProtoMsg::Node> ETFeederNode::getChakraNode() {
+  return nullptr;
+}
+
+} // namespace Chakra
+
+class NullNetwork : public AstraNetworkAPI {
+ public:
+  NullNetwork() : AstraNetworkAPI(0) {}
+  int sim_send(
+      void* buffer,
+      uint64_t count,
+      int type,
+      int dst,
+      int tag,
+      sim_request* request,
+      void (*msg_handler)(void* fun_arg),
+      void* fun_arg) {
+    return 0;
+  }
+  int sim_recv(
+      void* buffer,
+      uint64_t count,
+      int type,
+      int src,
+      int tag,
+      sim_request* request,
+      void (*msg_handler)(void* fun_arg),
+      void* fun_arg) {
+    return 0;
+  }
+  void schedule(
+      timespec_t delta,
+      void (*fun_ptr)(void* fun_arg),
+      void* fun_arg) {}
+  timespec_t sim_get_time() {
+    timespec_t time;
+    time.time_res = NS;
+    time.time_val = 0;
+    return time;
+  }
+  double get_BW_at_dimension(int dim) {
+    return 100;
+  }
+};
+
+class NullMemory : public AstraMemoryAPI {
+ public:
+  uint64_t mem_read(uint64_t size) {
+    return 0;
+  }
+  uint64_t mem_write(uint64_t size) {
+    return 0;
+  }
+  uint64_t npu_mem_read(uint64_t size) {
+    return 0;
+  }
+  uint64_t npu_mem_write(uint64_t size) {
+    return 0;
+  }
+  uint64_t nic_mem_read(uint64_t size) {
+    return 0;
+  }
+  uint64_t nic_mem_write(uint64_t size) {
+    return 0;
+  }
+};
+
+int main(int argc, char** argv) {
+  string system_configuration =
+      argc > 1 ? argv[1] : "benchmark/allocation_sys.json";
+  int collectives = argc > 2 ? atoi(argv[2]) : 100;
+  NullNetwork network;
+  NullMemory memory;
+  vector<int> physical_dims = {4, 4, 4};
+  vector<int> queues_per_dim = {1, 1, 1};
+  Sys* sys = new Sys(
+      0,
+      "empty",
+      "empty",
+      system_configuration,
+      &memory,
+      &network,
+      physical_dims,
+      queues_per_dim,
+      1,
+      1,
+      false);
+  vector<bool> involved_dimensions(physical_dims.size(), true);
+  // the first collective builds the logical topologies and the caches
+  sys->generate_all_reduce(1 << 20, involved_dimensions, nullptr, 0);
+  counting = true;
+  for (int i = 0; i < collectives; i++) {
+    sys->generate_all_reduce(1 << 20, involved_dimensions, nullptr, 0);
+  }
+  counting = false;
+  cout << system_configuration << ": " << allocations / collectives
+       << " allocations per all-reduce" << endl;
+  return 0;
+}
@@ -0,0 +1,162 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+// Steps per second of the peer walk of a direct collective (AllToAll), on a
+// homogeneous ring and on a custom ring (snake, graph and group rings). The
+// walk is timed as it was done before the peer tables: resolving the next
+// receiver and sender and the ring index of the receiver on every step, with
+// the hash-map based ring lookups kept below (LegacyRing), and with the peer
+// sequence resolved once (RingTopology::get_peers), as AllToAll does now.
+//
+// Build with -DASTRA_SIM_BUILD_BENCHMARKS=ON, or directly from the topology
+// sources RingTopology, TopologyRegistry, BinaryTree, TopologyGraph and Node:
+//   g++ -O2 -std=c++11 -I. benchmark/RingStepBenchmark.cc <topology sources>
+// Usage: RingStepBenchmark [nodes_in_ring] [steps]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "astra-sim/system/topology/RingTopology.hh"
+
+using namespace std;
+using namespace AstraSim;
+
+// The ring lookups of RingTopology before the neighbor tables: the index of
+// a node and the node at an index were hash-map lookups behind virtual calls.
+class LegacyRing {
+ public:
+  LegacyRing(vector<int> NPUs) {
+    total_nodes_in_ring = NPUs.size();
+    for (int i = 0; i < total_nodes_in_ring; i++) {
+      id_to_index[NPUs[i]] = i;
+      index_to_id[i] = NPUs[i];
+    }
+  }
+  virtual ~LegacyRing() = default;
+  virtual int get_receiver(int node_id, RingTopology::Direction direction) {
+    int index = id_to_index[node_id];
+    if (direction == RingTopology::Direction::Clockwise) {
+      index++;
+      if (index == total_nodes_in_ring) {
+        index = 0;
+      }
+      return index_to_id[index];
+    } else {
+      index--;
+      if (index < 0) {
+        index = total_nodes_in_ring - 1;
+      }
+      return index_to_id[index];
+    }
+  }
+  virtual int get_sender(int node_id, RingTopology::Direction direction) {
+    return get_receiver(
+        node_id,
+        direction == RingTopology::Direction::Clockwise
+            ? RingTopology::Direction::Anticlockwise
+            : RingTopology::Direction::Clockwise);
+  }
+  int get_index_of(int node_id) {
+    auto it = id_to_index.find(node_id);
+    if (it == id_to_index.end()) {
+      return -1;
+    }
+    return it->second;
+  }
+
+ private:
+  unordered_map<int, int> id_to_index;
+  unordered_map<int, int> index_to_id;
+  int total_nodes_in_ring;
+};
+
+static double steps_per_second(long steps, chrono::steady_clock::time_point start) {
+  double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+  return seconds > 0 ? steps / seconds : 0;
+}
+
+static void run(string name, RingTopology* ring, LegacyRing* legacy, int id, long steps) {
+  RingTopology::Direction direction = RingTopology::Direction::Clockwise;
+  int nodes = ring->get_nodes_in_ring();
+  vector<uint64_t> peer_send_size(nodes);
+  iota(peer_send_size.begin(), peer_send_size.end(), 1);
+  uint64_t lookup_checksum = 0;
+  uint64_t table_checksum = 0;
+
+  // per-step lookups, as before the peer tables
+  auto start = chrono::steady_clock::now();
+  int curr_receiver = legacy->get_receiver(id, direction);
+  int curr_sender = legacy->get_sender(id, direction);
+  for (long i = 0; i < steps; i++) {
+    lookup_checksum +=
+        curr_sender + peer_send_size[legacy->get_index_of(curr_receiver)];
+    curr_receiver = legacy->get_receiver(curr_receiver, direction);
+    if (curr_receiver == id) {
+      curr_receiver = legacy->get_receiver(curr_receiver, direction);
+    }
+    curr_sender = legacy->get_sender(curr_sender, direction);
+    if (curr_sender == id) {
+      curr_sender = legacy->get_sender(curr_sender, direction);
+    }
+  }
+  double lookup_rate = steps_per_second(steps, start);
+
+  // peer sequence resolved once
+  start = chrono::steady_clock::now();
+  vector<int> step_receivers = ring->get_peers(id, direction);
+  vector<int> step_senders =
+      ring->get_peers(id, RingTopology::Direction::Anticlockwise);
+  vector<int> step_receiver_indices;
+  for (int receiver : step_receivers) {
+    step_receiver_indices.push_back(ring->get_index_of(receiver));
+  }
+  int step = 0;
+  for (long i = 0; i < steps; i++) {
+    table_checksum +=
+        step_senders[step] + peer_send_size[step_receiver_indices[step]];
+    step = step + 1 == (int)step_receivers.size() ? 0 : step + 1;
+  }
+  double table_rate = steps_per_second(steps, start);
+
+  cout << name << " ring of " << nodes << " NPUs: hash-map lookups per step "
+       << lookup_rate << " steps/s, precomputed peers " << table_rate
+       << " steps/s (" << table_rate / lookup_rate << "x)" << endl;
+  // both walks visit the same peers
+  if (lookup_checksum != table_checksum) {
+    cerr << "the precomputed peers differ from the ring walk" << endl;
+    exit(1);
+  }
+}
+
+int main(int argc, char** argv) {
+  int nodes = argc > 1 ? atoi(argv[1]) : 64;
+  long steps = argc > 2 ? atol(argv[2]) : 50000000;
+  if (nodes < 2 || steps < 1) {
+    cerr << "Usage: " << argv[0] << " [nodes_in_ring >= 2] [steps >= 1]" << endl;
+    return 1;
+  }
+
+  vector<int> NPUs(nodes);
+  iota(NPUs.begin(), NPUs.end(), 0);
+  RingTopology homogeneous(
+      RingTopology::Dimension::Local, 0, nodes, 0, 1);
+  LegacyRing legacy_homogeneous(NPUs);
+  run("homogeneous", &homogeneous, &legacy_homogeneous, 0, steps);
+
+  mt19937 generator(0);
+  shuffle(NPUs.begin(), NPUs.end(), generator);
+  RingTopology custom(RingTopology::Dimension::Local, NPUs[0], NPUs);
+  LegacyRing legacy_custom(NPUs);
+  run("custom", &custom, &legacy_custom, NPUs[0], steps);
+  return 0;
+}
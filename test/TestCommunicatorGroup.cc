@@ -0,0 +1,97 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "astra-sim/system/CommunicatorGroup.hh"
+#include "astra-sim/system/topology/GeneralComplexTopology.hh"
+
+using namespace std;
+using namespace AstraSim;
+
+namespace {
+
+// The logical topology of NPU 0 with a ring on every dimension.
+class CommunicatorGroupTest : public ::testing::Test {
+ protected:
+  CommunicatorGroupTest() : ring(CollectiveImplType::Ring) {}
+
+  GeneralComplexTopology* make_topology(const vector<int>& dimension_size) {
+    vector<CollectiveImpl*> implementation(dimension_size.size(), &ring);
+    return new GeneralComplexTopology(0, dimension_size, implementation);
+  }
+
+  CollectiveImpl ring;
+};
+
+} // namespace
+
+TEST_F(CommunicatorGroupTest, SubLatticeOfTheFastDimension) {
+  GeneralComplexTopology* topology = make_topology({2, 4, 2});
+  vector<bool> dimensions_involved;
+  EXPECT_TRUE(CommunicatorGroup::get_sub_lattice(
+      topology, {0, 1}, 16, dimensions_involved));
+  EXPECT_EQ(dimensions_involved, vector<bool>({true, false, false}));
+  EXPECT_TRUE(CommunicatorGroup::get_sub_lattice(
+      topology, {10, 11, 12, 13, 14, 15, 8, 9}, 16, dimensions_involved));
+  EXPECT_EQ(dimensions_involved, vector<bool>({true, true, false}));
+  delete topology;
+}
+
+TEST_F(CommunicatorGroupTest, SubLatticeOfStridedDimensions) {
+  GeneralComplexTopology* topology = make_topology({2, 4, 2});
+  vector<bool> dimensions_involved;
+  EXPECT_TRUE(CommunicatorGroup::get_sub_lattice(
+      topology, {3, 11}, 16, dimensions_involved));
+  EXPECT_EQ(dimensions_involved, vector<bool>({false, false, true}));
+  EXPECT_TRUE(CommunicatorGroup::get_sub_lattice(
+      topology, {0, 1, 8, 9}, 16, dimensions_involved));
+  EXPECT_EQ(dimensions_involved, vector<bool>({true, false, true}));
+  delete topology;
+}
+
+TEST_F(CommunicatorGroupTest, SubLatticeOfTheWorld) {
+  GeneralComplexTopology* topology = make_topology({2, 2});
+  vector<bool> dimensions_involved;
+  EXPECT_TRUE(CommunicatorGroup::get_sub_lattice(
+      topology, {0, 1, 2, 3}, 4, dimensions_involved));
+  EXPECT_EQ(dimensions_involved, vector<bool>({true, true}));
+  delete topology;
+}
+
+TEST_F(CommunicatorGroupTest, PartialDimensionIsNotASubLattice) {
+  GeneralComplexTopology* topology = make_topology({2, 4, 2});
+  vector<bool> dimensions_involved;
+  EXPECT_FALSE(CommunicatorGroup::get_sub_lattice(
+      topology, {0, 2, 4}, 16, dimensions_involved));
+  delete topology;
+}
+
+TEST_F(CommunicatorGroupTest, DiagonalIsNotASubLattice) {
+  // both coordinates are spanned, but not all their combinations
+  GeneralComplexTopology* topology = make_topology({2, 2});
+  vector<bool> dimensions_involved;
+  EXPECT_FALSE(CommunicatorGroup::get_sub_lattice(
+      topology, {0, 3}, 4, dimensions_involved));
+  delete topology;
+}
+
+TEST_F(CommunicatorGroupTest, RepeatedNPUsAreNotASubLattice) {
+  GeneralComplexTopology* topology = make_topology({2, 2});
+  vector<bool> dimensions_involved;
+  EXPECT_FALSE(CommunicatorGroup::get_sub_lattice(
+      topology, {0, 1, 1}, 4, dimensions_involved));
+  delete topology;
+}
+
+TEST_F(CommunicatorGroupTest, TopologyOfAnotherSizeIsNotALattice) {
+  GeneralComplexTopology* topology = make_topology({2, 2});
+  vector<bool> dimensions_involved;
+  EXPECT_FALSE(CommunicatorGroup::get_sub_lattice(
+      topology, {0, 1}, 8, dimensions_involved));
+  delete topology;
+}
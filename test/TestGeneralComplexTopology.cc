@@ -0,0 +1,92 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+#include "astra-sim/system/topology/GeneralComplexTopology.hh"
+
+using namespace std;
+using namespace AstraSim;
+
+namespace {
+
+// The dimensions in which NPUs a and b differ, and by how much in the last
+// of them.
+int differing_dimensions(
+    int a,
+    int b,
+    const vector<int>& dimension_size,
+    int* distance) {
+  int differing = 0;
+  for (int size : dimension_size) {
+    if (a % size != b % size) {
+      differing++;
+      *distance = abs(a % size - b % size);
+    }
+    a /= size;
+    b /= size;
+  }
+  return differing;
+}
+
+void expect_snake(const vector<int>& dimension_size) {
+  vector<int> order = GeneralComplexTopology::get_snake_order(dimension_size);
+  int total = 1;
+  for (int size : dimension_size) {
+    total *= size;
+  }
+  ASSERT_EQ((int)order.size(), total);
+  vector<int> sorted = order;
+  sort(sorted.begin(), sorted.end());
+  for (int npu = 0; npu < total; npu++) {
+    EXPECT_EQ(sorted[npu], npu);
+  }
+  EXPECT_EQ(order[0], 0);
+  for (int i = 1; i < total; i++) {
+    int distance = 0;
+    EXPECT_EQ(
+        differing_dimensions(order[i - 1], order[i], dimension_size, &distance),
+        1);
+    EXPECT_EQ(distance, 1);
+  }
+}
+
+} // namespace
+
+TEST(GeneralComplexTopologyTest, SnakeOrderOfOneDimension) {
+  vector<int> order = GeneralComplexTopology::get_snake_order({5});
+  EXPECT_EQ(order, vector<int>({0, 1, 2, 3, 4}));
+}
+
+TEST(GeneralComplexTopologyTest, SnakeOrderOfTwoDimensions) {
+  vector<int> order = GeneralComplexTopology::get_snake_order({3, 2});
+  EXPECT_EQ(order, vector<int>({0, 1, 2, 5, 4, 3}));
+}
+
+TEST(GeneralComplexTopologyTest, SnakeOrderOfThreeDimensions) {
+  vector<int> order = GeneralComplexTopology::get_snake_order({2, 2, 2});
+  EXPECT_EQ(order, vector<int>({0, 1, 3, 2, 6, 7, 5, 4}));
+}
+
+TEST(GeneralComplexTopologyTest, SnakeOrderVisitsNeighbors) {
+  expect_snake({4, 4});
+  expect_snake({3, 5});
+  expect_snake({2, 3, 4});
+  expect_snake({5, 1, 3});
+}
+
+TEST(GeneralComplexTopologyTest, SnakeOrderWrapsAroundOnEvenDimension) {
+  vector<int> dimension_size = {3, 4, 2};
+  vector<int> order = GeneralComplexTopology::get_snake_order(dimension_size);
+  int distance = 0;
+  EXPECT_EQ(
+      differing_dimensions(order.back(), order.front(), dimension_size, &distance),
+      1);
+  EXPECT_EQ(distance, 1);
+}
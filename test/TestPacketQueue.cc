@@ -0,0 +1,119 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include <gtest/gtest.h>
+
+#include "astra-sim/system/PacketQueue.hh"
+
+using namespace AstraSim;
+
+namespace {
+
+void push(PacketQueue& queue, int stream_id) {
+  queue.push_back(0, 1, 2, stream_id, 1024);
+}
+
+void expect_stream_ids(PacketQueue& queue, uint64_t first, int count) {
+  ASSERT_EQ(queue.size(), count);
+  EXPECT_EQ(queue.begin_sequence(), first);
+  EXPECT_EQ(queue.end_sequence(), first + count);
+  for (int i = 0; i < count; i++) {
+    PacketDescriptor* packet = queue.find(first + i);
+    ASSERT_NE(packet, nullptr);
+    EXPECT_EQ(packet->stream_id, (int)(first + i));
+  }
+}
+
+} // namespace
+
+TEST(PacketQueueTest, PushAndPop) {
+  PacketQueue queue;
+  queue.reserve(4);
+  for (int i = 0; i < 3; i++) {
+    push(queue, i);
+  }
+  EXPECT_EQ(queue.front().stream_id, 0);
+  EXPECT_EQ(queue.front().preferred_src, 1);
+  EXPECT_EQ(queue.front().preferred_dest, 2);
+  EXPECT_EQ(queue.front().msg_size, 1024);
+  EXPECT_EQ(queue.front().ready_time, 0);
+  queue.pop_front();
+  EXPECT_EQ(queue.front().stream_id, 1);
+  expect_stream_ids(queue, 1, 2);
+}
+
+TEST(PacketQueueTest, WrapsAround) {
+  PacketQueue queue;
+  queue.reserve(4);
+  int next = 0;
+  // the window slides over the buffer several times without growing it
+  for (int round = 0; round < 10; round++) {
+    while (queue.size() < 4) {
+      push(queue, next++);
+    }
+    expect_stream_ids(queue, next - 4, 4);
+    queue.pop_front();
+    queue.pop_front();
+    queue.pop_front();
+  }
+  expect_stream_ids(queue, next - 1, 1);
+}
+
+TEST(PacketQueueTest, GrowsWhileWrapped) {
+  PacketQueue queue;
+  queue.reserve(4);
+  for (int i = 0; i < 4; i++) {
+    push(queue, i);
+  }
+  queue.pop_front();
+  queue.pop_front();
+  push(queue, 4);
+  push(queue, 5);
+  // the buffer is full and its head is in the middle: the packets keep their
+  // sequence numbers and their order when it doubles
+  push(queue, 6);
+  expect_stream_ids(queue, 2, 5);
+  for (int i = 7; i < 20; i++) {
+    push(queue, i);
+  }
+  expect_stream_ids(queue, 2, 18);
+  for (int i = 2; i < 20; i++) {
+    EXPECT_EQ(queue.front().stream_id, i);
+    queue.pop_front();
+  }
+  EXPECT_EQ(queue.size(), 0);
+}
+
+TEST(PacketQueueTest, GrowsWithoutReserve) {
+  PacketQueue queue;
+  for (int i = 0; i < 5; i++) {
+    push(queue, i);
+  }
+  expect_stream_ids(queue, 0, 5);
+}
+
+TEST(PacketQueueTest, FindOutsideTheQueue) {
+  PacketQueue queue;
+  queue.reserve(2);
+  push(queue, 0);
+  push(queue, 1);
+  queue.pop_front();
+  EXPECT_EQ(queue.find(0), nullptr);
+  EXPECT_NE(queue.find(1), nullptr);
+  EXPECT_EQ(queue.find(2), nullptr);
+}
+
+TEST(PacketQueueTest, ClearKeepsTheSequence) {
+  PacketQueue queue;
+  queue.reserve(2);
+  push(queue, 0);
+  push(queue, 1);
+  queue.clear();
+  EXPECT_EQ(queue.size(), 0);
+  EXPECT_EQ(queue.begin_sequence(), 2);
+  EXPECT_EQ(queue.end_sequence(), 2);
+  push(queue, 2);
+  expect_stream_ids(queue, 2, 1);
+}